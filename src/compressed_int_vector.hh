@@ -0,0 +1,262 @@
+#pragma once
+
+#include "growth.hh"
+#include "inplace_vector.hh"
+#include "vector.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace nstd {
+
+// An append only sequence of 64 bit integers that stores them bit packed, for large collections of IDs, timestamps and
+// other integers that are sorted or fall in a small range.
+//
+// Values are grouped into blocks of 128 that are encoded with frame of reference: every block stores its smallest
+// value as a base, and every value as its difference from the base, using just enough bits for the largest
+// difference. A block of values that are all within 2^w of each other therefore takes 2 * w words, plus a 16 byte
+// header. Sorted input compresses well since the values of a block are close to each other, and unlike delta encoding
+// any value can be decoded on its own, so random access is O(1).
+//
+// The values of a block are interleaved between two lanes, so that decoding a block handles two values with the same
+// shifts at a time. Sequential decoding through `for_each` uses a decoder specialized for each width, which the
+// compiler turns into vector shifts and masks without any intrinsics. Prefer it over operator[] for scans.
+//
+// The most recent values, up to a block, are kept uncompressed until the block is full.
+template <typename Allocator = std::allocator<std::uint64_t>> class compressed_int_vector {
+  public:
+    using size_type = std::size_t;
+    using value_type = std::uint64_t;
+    using allocator_type = Allocator;
+    using vector_type = vector<value_type, Allocator>;
+
+    static constexpr size_type s_block_size = 128;
+
+    // Where the bytes of a compressed_int_vector go
+    struct memory_usage {
+        size_type headers{0};
+        size_type words{0};
+        size_type pending{0};
+
+        [[nodiscard]] constexpr size_type total() const noexcept { return headers + words + pending; }
+    };
+
+    constexpr compressed_int_vector() = default;
+
+    constexpr explicit compressed_int_vector(const vector_type &values)
+        : m_headers(header_allocator_type(values.get_allocator())), m_words(values.get_allocator()) {
+        const value_type *first = values.data();
+        const size_type blocks = values.size() / s_block_size;
+        m_headers.reserve(blocks);
+        for (size_type block = 0; block < blocks; ++block) {
+            encode_block(first + (block * s_block_size));
+        }
+        for (size_type i = blocks * s_block_size; i < values.size(); ++i) {
+            m_pending.unchecked_emplace_back(first[i]);
+        }
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return (m_headers.size() * s_block_size) + m_pending.size();
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] constexpr value_type operator[](size_type i) const noexcept {
+        const size_type block = i / s_block_size;
+        if (block == m_headers.size()) {
+            return m_pending[i % s_block_size];
+        }
+
+        const auto &header = m_headers[block];
+        return header.base + unpack(m_words.data() + header.offset, header.width, i % s_block_size);
+    }
+
+    [[nodiscard]] constexpr value_type at(size_type i) const {
+        range_check(i);
+        return (*this)[i];
+    }
+
+    constexpr void push_back(value_type x) {
+        m_pending.unchecked_emplace_back(x);
+        if (m_pending.full()) {
+            try {
+                encode_block(m_pending.data());
+            } catch (...) {
+                m_pending.pop_back();
+                throw;
+            }
+            m_pending.clear();
+        }
+    }
+
+    // Calls `fn` with every value in order. Decoding a whole block at a time is much faster than indexing each value
+    template <typename Fn> constexpr void for_each(Fn fn) const {
+        std::array<value_type, s_block_size> decoded{};
+        for (const auto &header : m_headers) {
+            s_decoders[header.width](m_words.data() + header.offset, header.base, decoded.data());
+            for (const auto x : decoded) {
+                fn(x);
+            }
+        }
+        for (const auto x : m_pending) {
+            fn(x);
+        }
+    }
+
+    [[nodiscard]] constexpr vector_type to_vector() const {
+        vector_type values(m_words.get_allocator());
+        values.reserve(size());
+        for_each([&values](value_type x) { values.push_back(x); });
+        return values;
+    }
+
+    [[nodiscard]] constexpr memory_usage memory() const noexcept {
+        return {
+            .headers = m_headers.capacity() * sizeof(block_header),
+            .words = m_words.capacity() * sizeof(value_type),
+            .pending = sizeof(m_pending),
+        };
+    }
+
+  private:
+    struct block_header {
+        value_type base;
+        // Index of the first word of the block in m_words
+        std::uint64_t offset : 57;
+        // Bits per value, from 0 (all values in the block are equal) to 64
+        std::uint64_t width : 7;
+    };
+
+    using header_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<block_header>;
+
+    // The capacity the header and word vectors start with
+    static constexpr size_type s_default_capacity = 8;
+
+    // Value i of a block is stored in lane i % 2 at position i / 2. Position p of a lane starts at bit p * width, and
+    // the words of the two lanes alternate in memory
+    static constexpr size_type s_lanes = 2;
+    static constexpr size_type s_lane_size = s_block_size / s_lanes;
+    static constexpr size_type s_word_bits = 64;
+
+    [[nodiscard]] static constexpr value_type mask(size_type width) noexcept {
+        return width == s_word_bits ? ~value_type{0} : (value_type{1} << width) - 1;
+    }
+
+    [[nodiscard]] static constexpr value_type unpack(const value_type *words, size_type width, size_type i) noexcept {
+        // A block of equal values has no words at all
+        if (width == 0) {
+            return 0;
+        }
+
+        const size_type lane = i % s_lanes;
+        const size_type bit = (i / s_lanes) * width;
+        const size_type word = bit / s_word_bits;
+        const size_type shift = bit % s_word_bits;
+
+        value_type x = words[(word * s_lanes) + lane] >> shift;
+        if (shift + width > s_word_bits) {
+            x |= words[((word + 1) * s_lanes) + lane] << (s_word_bits - shift);
+        }
+        return x & mask(width);
+    }
+
+    // Decodes the values at `Position` in both lanes. Both lanes use the same word index and shifts, so the two values
+    // are decoded with a single vector instruction for each step
+    template <size_type Width, size_type Position>
+    static constexpr void decode_position(const value_type *words, value_type base, value_type *out) noexcept {
+        constexpr size_type bit = Position * Width;
+        constexpr size_type word = bit / s_word_bits;
+        constexpr size_type shift = bit % s_word_bits;
+
+        // All loads happen before the stores, otherwise the compiler has to assume that `out` may alias `words` and
+        // cannot combine the lanes
+        std::array<value_type, s_lanes> x{};
+        for (size_type lane = 0; lane < s_lanes; ++lane) {
+            x[lane] = words[(word * s_lanes) + lane] >> shift;
+            if constexpr (shift + Width > s_word_bits) {
+                x[lane] |= words[((word + 1) * s_lanes) + lane] << (s_word_bits - shift);
+            }
+        }
+        for (size_type lane = 0; lane < s_lanes; ++lane) {
+            out[(Position * s_lanes) + lane] = base + (x[lane] & mask(Width));
+        }
+    }
+
+    // Decodes the 128 values of a block into `out`. There is one of these for each width, with every position
+    // unrolled, so that all the shifts and masks are constants
+    template <size_type Width>
+    static constexpr void decode_block(const value_type *words, value_type base, value_type *out) noexcept {
+        if constexpr (Width == 0) {
+            std::fill_n(out, s_block_size, base);
+        } else {
+            [&]<size_type... Positions>(std::index_sequence<Positions...>) {
+                (decode_position<Width, Positions>(words, base, out), ...);
+            }(std::make_index_sequence<s_lane_size>{});
+        }
+    }
+
+    using block_decoder = void (*)(const value_type *words, value_type base, value_type *out) noexcept;
+
+    // decode_block for every width from 0 to 64, indexed by width
+    static constexpr auto s_decoders = []<size_type... Widths>(std::index_sequence<Widths...>) {
+        return std::array<block_decoder, sizeof...(Widths)>{&decode_block<Widths>...};
+    }(std::make_index_sequence<s_word_bits + 1>{});
+
+    // Makes room for `n` more elements, growing geometrically
+    template <typename Vector> static constexpr void reserve_for(Vector &vec, size_type n) {
+        if (vec.size() + n > vec.capacity()) {
+            vec.reserve(detail::grow_capacity(vec.capacity(), vec.size() + n, s_default_capacity));
+        }
+    }
+
+    constexpr void encode_block(const value_type *values) {
+        const auto [min, max] = std::minmax_element(values, values + s_block_size);
+        const value_type base = *min;
+        const auto width = static_cast<size_type>(std::bit_width(*max - base));
+        const size_type offset = m_words.size();
+
+        // Allocate first so that a failed allocation does not leave a header without its words
+        reserve_for(m_headers, 1);
+        reserve_for(m_words, s_lanes * width);
+
+        m_headers.push_back({.base = base, .offset = offset, .width = width});
+        for (size_type i = 0; i < s_lanes * width; ++i) {
+            m_words.push_back(0);
+        }
+
+        value_type *words = m_words.data() + offset;
+        for (size_type i = 0; i < s_block_size && width > 0; ++i) {
+            const value_type x = values[i] - base;
+            const size_type lane = i % s_lanes;
+            const size_type bit = (i / s_lanes) * width;
+            const size_type word = bit / s_word_bits;
+            const size_type shift = bit % s_word_bits;
+
+            words[(word * s_lanes) + lane] |= x << shift;
+            if (shift + width > s_word_bits) {
+                words[((word + 1) * s_lanes) + lane] |= x >> (s_word_bits - shift);
+            }
+        }
+    }
+
+    constexpr void range_check(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range(
+                std::format("Index {} out of range for compressed_int_vector of size {}", i, size()));
+        }
+    }
+
+    vector<block_header, header_allocator_type> m_headers;
+    vector_type m_words;
+    inplace_vector<value_type, s_block_size> m_pending;
+};
+
+} // namespace nstd
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "shared_ptr.hh"
+#include "vector.hh"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+namespace nstd {
+
+// A copy-on-write wrapper around `vector`. Copies of a cow_vector share the same underlying storage through a
+// `shared_ptr`, so taking a snapshot is O(1). The storage is only copied the first time a handle that shares it is
+// mutated.
+//
+// Reading and writing are deliberately separated in the API: every const member function only reads and will never
+// copy, while all non-const member functions may detach (deep copy) if the storage is shared. There is no mutable
+// operator[] or mutable iterators, since handing out references into shared storage would let writes leak into other
+// snapshots. To modify elements directly, use `modify()` which detaches once and calls a function with the underlying
+// vector.
+//
+// Like std::shared_ptr, a single cow_vector handle is not safe to mutate from several threads at once, but separate
+// handles that share storage can be used from different threads.
+template <typename T, typename Allocator = std::allocator<T>> class cow_vector {
+  public:
+    using vector_type = vector<T, Allocator>;
+    using size_type = typename vector_type::size_type;
+    using allocator_type = typename vector_type::allocator_type;
+    using value_type = typename vector_type::value_type;
+    using reference = typename vector_type::reference;
+    using const_reference = typename vector_type::const_reference;
+    using rvalue_reference = typename vector_type::rvalue_reference;
+    using pointer = typename vector_type::pointer;
+    using const_pointer = typename vector_type::const_pointer;
+    using const_iterator = typename vector_type::const_iterator;
+
+    constexpr cow_vector() = default;
+
+    constexpr cow_vector(std::initializer_list<T> init) : m_data(new vector_type(init)) {}
+
+    constexpr explicit cow_vector(const vector_type &other) : m_data(new vector_type(other)) {}
+
+    constexpr explicit cow_vector(vector_type &&other) : m_data(new vector_type(std::move(other))) {}
+
+    [[nodiscard]] constexpr bool operator==(const cow_vector &other) const {
+        return m_data.get() == other.m_data.get() || read() == other.read();
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const cow_vector &other) const { return !(*this == other); }
+
+    // Read access. None of these will ever copy the underlying storage
+
+    [[nodiscard]] constexpr const vector_type &read() const noexcept { return m_data ? *m_data : s_empty; }
+
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return read().begin(); }
+
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return read().cbegin(); }
+
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return read().end(); }
+
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return read().cend(); }
+
+    [[nodiscard]] constexpr const_reference front() const noexcept { return read().front(); }
+
+    [[nodiscard]] constexpr const_reference back() const noexcept { return read().back(); }
+
+    [[nodiscard]] constexpr const_reference operator[](size_type i) const noexcept { return read()[i]; }
+
+    [[nodiscard]] constexpr const_reference at(size_type i) const { return read().at(i); }
+
+    [[nodiscard]] constexpr const_pointer data() const noexcept { return read().data(); }
+
+    [[nodiscard]] constexpr size_type size() const noexcept { return read().size(); }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept { return read().capacity(); }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return read().empty(); }
+
+    // Whether this handle currently shares its storage with any other handle, i.e. whether the next mutation will copy
+    [[nodiscard]] constexpr bool is_shared() const noexcept { return m_data.use_count() > 1; }
+
+    [[nodiscard]] constexpr int64_t use_count() const noexcept { return m_data.use_count(); }
+
+    // Write access. All of these detach from any other handles sharing the storage before modifying it
+
+    // Calls `fn` with the underlying vector and returns its result. The vector is only lent out for the duration of the
+    // call, since a reference kept after this handle is copied would write into storage shared with the copy. For the
+    // same reason `fn` should not copy this handle or keep references into the vector
+    template <typename Fn> constexpr decltype(auto) modify(Fn &&fn) {
+        return std::invoke(std::forward<Fn>(fn), write());
+    }
+
+    constexpr void set(size_type i, const_reference x) { write().at(i) = x; }
+
+    constexpr void set(size_type i, rvalue_reference x) { write().at(i) = std::move(x); }
+
+    constexpr void push_back(const_reference x) { write().push_back(x); }
+
+    constexpr void push_back(rvalue_reference x) { write().push_back(std::move(x)); }
+
+    template <typename... Args> constexpr void emplace_back(Args &&...args) {
+        write().emplace_back(std::forward<Args>(args)...);
+    }
+
+    constexpr void pop_back() {
+        assert(!empty());
+        write().pop_back();
+    }
+
+    constexpr void reserve(size_type n) { write().reserve(n); }
+
+    // Clearing a shared vector just drops our reference instead of copying elements only to destroy them afterwards
+    constexpr void clear() noexcept {
+        if (is_shared()) {
+            m_data.reset();
+        } else if (m_data) {
+            m_data->clear();
+        }
+    }
+
+  private:
+    // Only for single operations that do not hand the vector out, see modify
+    [[nodiscard]] constexpr vector_type &write() {
+        detach();
+        return *m_data;
+    }
+
+    // Used as the storage for reads on a default constructed (or cleared) cow_vector, so that reads never allocate
+    static inline const vector_type s_empty{};
+
+    // Make sure this handle is the sole owner of its storage, copying it if it is shared with any other handles
+    constexpr void detach() {
+        if (!m_data) {
+            m_data = shared_ptr<vector_type>(new vector_type());
+        } else if (is_shared()) {
+            m_data = shared_ptr<vector_type>(new vector_type(*m_data));
+        }
+    }
+
+    shared_ptr<vector_type> m_data{};
+};
+
+} // namespace nstd
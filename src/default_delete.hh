@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace nstd {
+
+template <typename T> struct default_delete {
+    constexpr default_delete() noexcept = default;
+
+    constexpr void operator()(T *ptr) const { delete ptr; }
+};
+
+template <typename T> struct default_delete<T[]> {
+    constexpr default_delete() noexcept = default;
+
+    constexpr void operator()(T *ptr) const { delete[] ptr; }
+};
+
+// Deleter for arrays allocated with an alignment stronger than the default, e.g. buffers used with SIMD instructions.
+// Unlike default_delete this has to remember the size and alignment of the allocation, since they are needed to
+// destroy the elements and to pick the matching aligned operator delete
+template <typename T> struct aligned_delete;
+
+template <typename T> struct aligned_delete<T[]> {
+    using size_type = std::size_t;
+
+    constexpr aligned_delete() noexcept = default;
+
+    constexpr aligned_delete(size_type size, std::align_val_t alignment) noexcept
+        : m_size(size), m_alignment(alignment) {}
+
+    void operator()(T *ptr) const noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        std::destroy_n(ptr, m_size);
+        ::operator delete(ptr, m_alignment);
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept { return m_size; }
+
+    [[nodiscard]] constexpr std::align_val_t alignment() const noexcept { return m_alignment; }
+
+  private:
+    size_type m_size{0};
+    std::align_val_t m_alignment{alignof(T)};
+};
+
+// Allocates `n` default initialized elements of type T aligned to `alignment`. For trivial types this leaves the
+// memory uninitialized. The returned pointer must be freed with aligned_delete<T[]>{n, alignment}
+template <typename T> [[nodiscard]] T *allocate_aligned_for_overwrite(std::size_t n, std::align_val_t alignment) {
+    assert(static_cast<std::size_t>(alignment) >= alignof(T));
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+
+    auto *ptr = static_cast<T *>(::operator new(n * sizeof(T), alignment));
+    try {
+        std::uninitialized_default_construct_n(ptr, n);
+    } catch (...) {
+        ::operator delete(ptr, alignment);
+        throw;
+    }
+    return ptr;
+}
+
+} // namespace nstd
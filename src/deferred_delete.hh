@@ -0,0 +1,241 @@
+#pragma once
+
+#include "vector.hh"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace nstd {
+
+// Counters describing how much work the reclaimer has done and how much is still waiting
+struct deferred_reclaimer_stats {
+    // Objects handed to the shared queue that have not been destroyed yet. Objects still sitting in a thread's local
+    // batch are not counted until that batch is flushed
+    std::size_t backlog;
+    // Objects ever handed to `defer`
+    std::size_t deferred;
+    // Objects destroyed by `drain` or the background thread
+    std::size_t reclaimed;
+    // Objects destroyed immediately by the deferring thread because the backlog was full
+    std::size_t reclaimed_inline;
+};
+
+// Moves destruction of objects off latency critical threads. Objects passed to `defer` are first collected in a small
+// batch local to the calling thread, which is handed to a shared queue once it fills up, so the shared queue's lock is
+// only taken once per batch. The shared queue is destroyed by calling `drain`, or continuously by a background thread
+// started with `start`.
+//
+// The shared queue is bounded by `max_backlog`. If a thread flushes a batch while the backlog is full, it destroys
+// the batch itself instead, trading latency for bounded memory use.
+class deferred_reclaimer {
+  public:
+    using size_type = std::size_t;
+    using destroy_function = void (*)(void *);
+
+    // Objects collected on a thread before they are handed to the shared queue
+    static constexpr size_type s_batch_size = 64;
+    static constexpr size_type s_default_max_backlog = size_type{1} << 16;
+
+    [[nodiscard]] static deferred_reclaimer &instance() noexcept {
+        static deferred_reclaimer reclaimer;
+        return reclaimer;
+    }
+
+    deferred_reclaimer(const deferred_reclaimer &other) = delete;
+    deferred_reclaimer &operator=(const deferred_reclaimer &other) = delete;
+    deferred_reclaimer(deferred_reclaimer &&other) = delete;
+    deferred_reclaimer &operator=(deferred_reclaimer &&other) = delete;
+
+    // Thread local batches may already be gone when this runs during static destruction, so only the shared queue is
+    // drained here. Destroying objects may defer even more objects, so keep going until nothing is left
+    ~deferred_reclaimer() noexcept {
+        stop();
+        while (drain_shared() > 0) {
+        }
+    }
+
+    // Schedule `destroy(ptr)` to be called later
+    void defer(void *ptr, destroy_function destroy) noexcept {
+        m_deferred.fetch_add(1, std::memory_order_relaxed);
+
+        auto &batch = local_batch();
+        batch.items.push_back(entry{.ptr = ptr, .destroy = destroy});
+        if (batch.items.size() >= s_batch_size) {
+            flush(batch.items);
+        }
+    }
+
+    // Hand the calling thread's batch to the shared queue without waiting for it to fill up
+    void flush() noexcept { flush(local_batch().items); }
+
+    // Destroy everything in the shared queue, including the calling thread's batch. Returns the number of objects
+    // destroyed
+    size_type drain() noexcept {
+        flush();
+        return drain_shared();
+    }
+
+    // Start a background thread that drains the shared queue whenever a batch is flushed to it, or at least every
+    // `interval`. Does nothing if the thread is already running
+    void start(std::chrono::milliseconds interval = std::chrono::milliseconds{10}) {
+        std::scoped_lock lock(m_thread_mutex);
+        if (m_thread.joinable()) {
+            return;
+        }
+
+        m_thread = std::jthread([this, interval](const std::stop_token &stop) {
+            while (!stop.stop_requested()) {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_wake.wait_for(lock, stop, interval, [this] { return !m_queue.empty(); });
+                }
+                // Objects destroyed here may defer other objects to this thread's batch, so flush that as well
+                drain();
+            }
+        });
+    }
+
+    // Stop the background thread, if running. Objects still in the queue are left for `drain`
+    void stop() noexcept {
+        std::scoped_lock lock(m_thread_mutex);
+        if (m_thread.joinable()) {
+            m_thread.request_stop();
+            m_thread.join();
+        }
+    }
+
+    void set_max_backlog(size_type max_backlog) noexcept {
+        m_max_backlog.store(max_backlog, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_type max_backlog() const noexcept { return m_max_backlog.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] deferred_reclaimer_stats stats() const noexcept {
+        return {
+            .backlog = m_backlog.load(std::memory_order_relaxed),
+            .deferred = m_deferred.load(std::memory_order_relaxed),
+            .reclaimed = m_reclaimed.load(std::memory_order_relaxed),
+            .reclaimed_inline = m_reclaimed_inline.load(std::memory_order_relaxed),
+        };
+    }
+
+  private:
+    struct entry {
+        void *ptr;
+        destroy_function destroy;
+    };
+
+    // Flushes whatever is left in a thread's batch when the thread exits, so nothing is leaked
+    struct thread_batch {
+        thread_batch() { items.reserve(s_batch_size); }
+
+        thread_batch(const thread_batch &other) = delete;
+        thread_batch &operator=(const thread_batch &other) = delete;
+        thread_batch(thread_batch &&other) = delete;
+        thread_batch &operator=(thread_batch &&other) = delete;
+
+        ~thread_batch() noexcept { instance().flush(items); }
+
+        vector<entry> items;
+    };
+
+    deferred_reclaimer() noexcept = default;
+
+    [[nodiscard]] static thread_batch &local_batch() noexcept {
+        thread_local thread_batch batch;
+        return batch;
+    }
+
+    void flush(vector<entry> &items) noexcept {
+        if (items.empty()) {
+            return;
+        }
+
+        bool queued = false;
+        {
+            std::scoped_lock lock(m_mutex);
+            const size_type old_size = m_queue.size();
+            if (old_size + items.size() <= max_backlog()) {
+                try {
+                    for (const auto &item : items) {
+                        m_queue.push_back(item);
+                    }
+                    queued = true;
+                    m_backlog.store(m_queue.size(), std::memory_order_relaxed);
+                } catch (...) {
+                    // Could not grow the queue. Undo the partial append and fall back to destroying inline, since a
+                    // deleter must not throw
+                    while (m_queue.size() > old_size) {
+                        m_queue.pop_back();
+                    }
+                }
+            }
+        }
+
+        if (queued) {
+            m_wake.notify_one();
+            items.clear();
+            return;
+        }
+
+        // The destructors we call may defer more objects into `items`, so take them out of the batch first
+        vector<entry> overflow(std::move(items));
+        items.reserve(s_batch_size);
+        for (const auto &item : overflow) {
+            item.destroy(item.ptr);
+        }
+        m_reclaimed_inline.fetch_add(overflow.size(), std::memory_order_relaxed);
+    }
+
+    // Like `drain`, but without flushing the calling thread's batch
+    size_type drain_shared() noexcept {
+        vector<entry> items;
+        {
+            std::scoped_lock lock(m_mutex);
+            items = std::move(m_queue);
+            m_backlog.store(0, std::memory_order_relaxed);
+        }
+
+        for (const auto &item : items) {
+            item.destroy(item.ptr);
+        }
+        m_reclaimed.fetch_add(items.size(), std::memory_order_relaxed);
+
+        return items.size();
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_wake;
+    vector<entry> m_queue;
+
+    std::mutex m_thread_mutex;
+    std::jthread m_thread;
+
+    std::atomic<size_type> m_max_backlog{s_default_max_backlog};
+    std::atomic<size_type> m_backlog{0};
+    std::atomic<size_type> m_deferred{0};
+    std::atomic<size_type> m_reclaimed{0};
+    std::atomic<size_type> m_reclaimed_inline{0};
+};
+
+// A deleter for `unique_ptr` and `shared_ptr` that hands the object to the `deferred_reclaimer` instead of destroying
+// it right away. E.g.:
+//     nstd::unique_ptr<T, nstd::deferred_delete<T>> a(new T);
+//     nstd::shared_ptr<T> b(new T, nstd::deferred_delete<T>{});
+template <typename T> struct deferred_delete {
+    constexpr deferred_delete() noexcept = default;
+
+    void operator()(T *ptr) const noexcept {
+        if (ptr != nullptr) {
+            deferred_reclaimer::instance().defer(ptr, [](void *p) { delete static_cast<T *>(p); });
+        }
+    }
+};
+
+} // namespace nstd
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace nstd::detail {
+
+// How much containers grow by when they run out of space. Growing geometrically keeps appending amortized O(1)
+inline constexpr std::size_t s_growth_factor = 2;
+
+// The capacity a container with room for `capacity` elements should grow to when it needs room for `required`
+// elements. `initial` is the capacity to start with for an empty container
+[[nodiscard]] constexpr std::size_t grow_capacity(std::size_t capacity, std::size_t required,
+                                                  std::size_t initial) noexcept {
+    return std::max(required, capacity == 0 ? initial : capacity * s_growth_factor);
+}
+
+} // namespace nstd::detail
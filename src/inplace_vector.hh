@@ -0,0 +1,273 @@
+#pragma once
+
+#include "normal_iterator.hh"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <format>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace nstd {
+
+// A vector with a fixed capacity of N elements stored inline in the object itself, so it never allocates.
+//
+// For trivial element types the storage is a plain array that is always fully initialized, which makes
+// inplace_vector usable in constant expressions, e.g. for tables built at compile time. For other types the storage
+// is left uninitialized and elements are constructed as they are added, like in `vector`.
+//
+// push_back and emplace_back throw std::bad_alloc when the vector is full. On hot paths that should not throw, use
+// try_push_back and try_emplace_back, which return a null pointer instead.
+template <typename T, std::size_t N> class inplace_vector {
+  public:
+    using size_type = std::size_t;
+    using value_type = T;
+    using reference = T &;
+    using const_reference = const T &;
+    using rvalue_reference = T &&;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = normal_iterator<pointer, inplace_vector>;
+    using const_iterator = normal_iterator<const_pointer, inplace_vector>;
+
+    constexpr inplace_vector() noexcept = default;
+
+    constexpr inplace_vector(std::initializer_list<T> init) {
+        if (init.size() > N) {
+            throw std::bad_alloc();
+        }
+
+        range_initialize(init.begin(), init.end());
+    }
+
+    constexpr inplace_vector(const inplace_vector &other)
+        requires std::is_trivial_v<T>
+    = default;
+
+    constexpr inplace_vector(const inplace_vector &other) { range_initialize(other.begin(), other.end()); }
+
+    constexpr inplace_vector(inplace_vector &&other) noexcept
+        requires std::is_trivial_v<T>
+    = default;
+
+    constexpr inplace_vector(inplace_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        range_initialize(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        other.clear();
+    }
+
+    constexpr inplace_vector &operator=(const inplace_vector &other)
+        requires std::is_trivial_v<T>
+    = default;
+
+    constexpr inplace_vector &operator=(const inplace_vector &other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+        for (const auto &x : other) {
+            unchecked_emplace_back(x);
+        }
+
+        return *this;
+    }
+
+    constexpr inplace_vector &operator=(inplace_vector &&other) noexcept
+        requires std::is_trivial_v<T>
+    = default;
+
+    constexpr inplace_vector &operator=(inplace_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+        for (auto &x : other) {
+            unchecked_emplace_back(std::move(x));
+        }
+        other.clear();
+
+        return *this;
+    }
+
+    constexpr ~inplace_vector() noexcept
+        requires std::is_trivial_v<T>
+    = default;
+
+    constexpr ~inplace_vector() noexcept { clear(); }
+
+    [[nodiscard]] constexpr bool operator==(const inplace_vector &other) const {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const inplace_vector &other) const { return !(*this == other); }
+
+    [[nodiscard]] constexpr iterator begin() noexcept { return iterator{data()}; }
+
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return const_iterator{data()}; }
+
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return const_iterator{data()}; }
+
+    [[nodiscard]] constexpr iterator end() noexcept { return iterator{data() + m_size}; }
+
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return const_iterator{data() + m_size}; }
+
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return const_iterator{data() + m_size}; }
+
+    [[nodiscard]] constexpr reference front() noexcept {
+        assert(!empty());
+        return *begin();
+    }
+
+    [[nodiscard]] constexpr const_reference front() const noexcept {
+        assert(!empty());
+        return *begin();
+    }
+
+    [[nodiscard]] constexpr reference back() noexcept {
+        assert(!empty());
+        return *(end() - 1);
+    }
+
+    [[nodiscard]] constexpr const_reference back() const noexcept {
+        assert(!empty());
+        return *(end() - 1);
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept { return m_size; }
+
+    [[nodiscard]] static constexpr size_type capacity() noexcept { return N; }
+
+    [[nodiscard]] constexpr const_pointer data() const noexcept {
+        if constexpr (s_trivial) {
+            return m_storage.data();
+        } else {
+            return m_storage.data;
+        }
+    }
+
+    [[nodiscard]] constexpr pointer data() noexcept {
+        if constexpr (s_trivial) {
+            return m_storage.data();
+        } else {
+            return m_storage.data;
+        }
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] constexpr bool full() const noexcept { return m_size == N; }
+
+    constexpr void clear() noexcept {
+        if constexpr (!s_trivial) {
+            std::destroy(begin(), end());
+        }
+        m_size = 0;
+    }
+
+    [[nodiscard]] constexpr reference operator[](size_type i) noexcept { return *(begin() + i); }
+
+    [[nodiscard]] constexpr const_reference operator[](size_type i) const noexcept { return *(begin() + i); }
+
+    [[nodiscard]] constexpr reference at(size_type i) {
+        range_check(i);
+        return (*this)[i];
+    }
+
+    [[nodiscard]] constexpr const_reference at(size_type i) const {
+        range_check(i);
+        return (*this)[i];
+    }
+
+    constexpr void push_back(const_reference x) { emplace_back(x); }
+
+    constexpr void push_back(rvalue_reference x) { emplace_back(std::move(x)); }
+
+    // Same as vector::emplace_back this returns void rather than a reference to the new element
+    template <typename... Args> constexpr void emplace_back(Args &&...args) {
+        if (full()) {
+            throw std::bad_alloc();
+        }
+
+        unchecked_emplace_back(std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] constexpr pointer try_push_back(const_reference x) { return try_emplace_back(x); }
+
+    [[nodiscard]] constexpr pointer try_push_back(rvalue_reference x) { return try_emplace_back(std::move(x)); }
+
+    // Returns a pointer to the new element, or nullptr without touching `args` if the vector is full
+    template <typename... Args> [[nodiscard]] constexpr pointer try_emplace_back(Args &&...args) {
+        if (full()) {
+            return nullptr;
+        }
+
+        unchecked_emplace_back(std::forward<Args>(args)...);
+        return &back();
+    }
+
+    // Undefined behavior if the vector is full. For when the caller already knows there is room
+    template <typename... Args> constexpr void unchecked_emplace_back(Args &&...args) {
+        assert(!full());
+        std::construct_at(data() + m_size, std::forward<Args>(args)...);
+        ++m_size;
+    }
+
+    constexpr void pop_back() noexcept {
+        assert(!empty());
+        --m_size;
+        if constexpr (!s_trivial) {
+            std::destroy_at(data() + m_size);
+        }
+    }
+
+  private:
+    static constexpr bool s_trivial = std::is_trivial_v<T>;
+
+    // Uninitialized storage for non trivial types. Elements are constructed and destroyed individually
+    union uninitialized_storage {
+        constexpr uninitialized_storage() noexcept {}
+
+        constexpr ~uninitialized_storage() noexcept {}
+
+        uninitialized_storage(const uninitialized_storage &other) = delete;
+        uninitialized_storage &operator=(const uninitialized_storage &other) = delete;
+        uninitialized_storage(uninitialized_storage &&other) = delete;
+        uninitialized_storage &operator=(uninitialized_storage &&other) = delete;
+
+        // Zero length arrays are not allowed, so an inplace_vector<T, 0> wastes space for a single element
+        T data[N == 0 ? 1 : N];
+    };
+
+    using storage_type = std::conditional_t<s_trivial, std::array<T, N>, uninitialized_storage>;
+
+    // For constructors, whose elements would not be destroyed by the destructor if one of them throws
+    template <typename Iterator> constexpr void range_initialize(Iterator first, Iterator last) {
+        try {
+            for (; first != last; ++first) {
+                unchecked_emplace_back(*first);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    constexpr void range_check(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range(std::format("Index {} out of range for inplace_vector of size {}", i, m_size));
+        }
+    }
+
+    storage_type m_storage{};
+    size_type m_size{0};
+};
+
+} // namespace nstd
@@ -0,0 +1,538 @@
+#pragma once
+
+#include "shared_ptr.hh"
+#include "unique_ptr.hh"
+#include "vector.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Runtime polymorphic allocation. Containers using a polymorphic_allocator have the same type no matter which
+// memory_resource they allocate from, so the allocation strategy can be picked at runtime without it leaking into
+// every type and template that touches the container.
+namespace nstd::pmr {
+
+class memory_resource {
+  public:
+    static constexpr std::size_t s_max_align = alignof(std::max_align_t);
+
+    memory_resource() = default;
+    memory_resource(const memory_resource &other) = default;
+    memory_resource &operator=(const memory_resource &other) = default;
+    memory_resource(memory_resource &&other) = default;
+    memory_resource &operator=(memory_resource &&other) = default;
+    virtual ~memory_resource() = default;
+
+    [[nodiscard]] void *allocate(std::size_t bytes, std::size_t alignment = s_max_align) {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void *ptr, std::size_t bytes, std::size_t alignment = s_max_align) {
+        do_deallocate(ptr, bytes, alignment);
+    }
+
+    // Whether memory allocated from `other` can be deallocated through this resource and vice versa
+    [[nodiscard]] bool is_equal(const memory_resource &other) const noexcept { return do_is_equal(other); }
+
+  private:
+    virtual void *do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) = 0;
+    [[nodiscard]] virtual bool do_is_equal(const memory_resource &other) const noexcept = 0;
+};
+
+[[nodiscard]] inline bool operator==(const memory_resource &a, const memory_resource &b) noexcept {
+    return &a == &b || a.is_equal(b);
+}
+
+// Forwards to the global aligned operator new and delete
+class new_delete_resource_type final : public memory_resource {
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return ::operator new(bytes, std::align_val_t{alignment});
+    }
+
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override {
+        ::operator delete(ptr, bytes, std::align_val_t{alignment});
+    }
+
+    [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override { return this == &other; }
+};
+
+[[nodiscard]] inline memory_resource *new_delete_resource() noexcept {
+    static new_delete_resource_type resource;
+    return &resource;
+}
+
+namespace detail {
+
+[[nodiscard]] inline std::atomic<memory_resource *> &default_resource() noexcept {
+    static std::atomic<memory_resource *> resource{new_delete_resource()};
+    return resource;
+}
+
+} // namespace detail
+
+// The resource used by default constructed polymorphic_allocators and memory resources without an explicit upstream
+[[nodiscard]] inline memory_resource *get_default_resource() noexcept { return detail::default_resource().load(); }
+
+// Returns the previous default resource. Passing nullptr resets the default to new_delete_resource()
+inline memory_resource *set_default_resource(memory_resource *resource) noexcept {
+    return detail::default_resource().exchange(resource != nullptr ? resource : new_delete_resource());
+}
+
+// Hands out memory by bumping a pointer through a buffer, and never frees anything until the resource is destroyed or
+// `release` is called. When the buffer runs out a new one, twice as large, is allocated from the upstream resource.
+// Very fast for short lived groups of allocations, e.g. everything allocated while handling a single request.
+class monotonic_buffer_resource : public memory_resource {
+  public:
+    using size_type = std::size_t;
+
+    explicit monotonic_buffer_resource(memory_resource *upstream = get_default_resource()) noexcept
+        : m_upstream(upstream) {}
+
+    monotonic_buffer_resource(size_type initial_size, memory_resource *upstream = get_default_resource()) noexcept
+        : m_upstream(upstream), m_next_chunk_size(std::max(initial_size, s_min_chunk_size)) {}
+
+    // Allocations are served from `buffer` until it runs out. The buffer is not owned by the resource
+    monotonic_buffer_resource(void *buffer, size_type size, memory_resource *upstream = get_default_resource()) noexcept
+        : m_upstream(upstream), m_current(static_cast<std::byte *>(buffer)), m_remaining(size),
+          m_next_chunk_size(std::max(size * s_growth_factor, s_min_chunk_size)) {}
+
+    monotonic_buffer_resource(const monotonic_buffer_resource &other) = delete;
+    monotonic_buffer_resource &operator=(const monotonic_buffer_resource &other) = delete;
+    monotonic_buffer_resource(monotonic_buffer_resource &&other) = delete;
+    monotonic_buffer_resource &operator=(monotonic_buffer_resource &&other) = delete;
+
+    ~monotonic_buffer_resource() override { release(); }
+
+    // Give all memory allocated from upstream back to it. Memory from an initial buffer is not reused afterwards
+    void release() noexcept {
+        while (m_chunks != nullptr) {
+            chunk *previous = m_chunks->previous;
+            m_upstream->deallocate(m_chunks, m_chunks->size, alignof(chunk));
+            m_chunks = previous;
+        }
+        m_current = nullptr;
+        m_remaining = 0;
+    }
+
+    [[nodiscard]] memory_resource *upstream_resource() const noexcept { return m_upstream; }
+
+  private:
+    // Header placed at the start of every chunk allocated from upstream, so the chunks can be freed in `release`
+    struct chunk {
+        chunk *previous;
+        size_type size;
+    };
+
+    static constexpr size_type s_min_chunk_size = 1024;
+    static constexpr size_type s_growth_factor = 2;
+
+    void *do_allocate(size_type bytes, size_type alignment) override {
+        void *ptr = m_current;
+        if (ptr == nullptr || std::align(alignment, bytes, ptr, m_remaining) == nullptr) {
+            allocate_chunk(bytes, alignment);
+            ptr = m_current;
+            std::align(alignment, bytes, ptr, m_remaining);
+        }
+
+        m_current = static_cast<std::byte *>(ptr) + bytes;
+        m_remaining -= bytes;
+        return ptr;
+    }
+
+    void do_deallocate(void * /*ptr*/, size_type /*bytes*/, size_type /*alignment*/) override {}
+
+    [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override { return this == &other; }
+
+    void allocate_chunk(size_type bytes, size_type alignment) {
+        // Make sure the allocation fits even when the start of the chunk has to be padded for alignment
+        const size_type size = std::max(m_next_chunk_size, sizeof(chunk) + bytes + alignment);
+        auto *new_chunk = ::new (m_upstream->allocate(size, alignof(chunk))) chunk{.previous = m_chunks, .size = size};
+
+        m_chunks = new_chunk;
+        m_current = reinterpret_cast<std::byte *>(new_chunk + 1);
+        m_remaining = size - sizeof(chunk);
+        m_next_chunk_size = size * s_growth_factor;
+    }
+
+    memory_resource *m_upstream;
+    chunk *m_chunks{nullptr};
+    std::byte *m_current{nullptr};
+    size_type m_remaining{0};
+    size_type m_next_chunk_size{s_min_chunk_size};
+};
+
+struct pool_options {
+    // Upper bound for how many blocks are allocated from upstream at once for a single pool. 0 means a default
+    std::size_t max_blocks_per_chunk{0};
+    // Allocations larger than this bypass the pools and go straight to upstream. 0 means a default
+    std::size_t largest_required_pool_block{0};
+};
+
+// Keeps a pool of free blocks for each power of two size from 8 bytes up to `largest_required_pool_block`. Freed blocks
+// go back to their pool and are reused for the next allocation of the same size class, so after warming up most
+// allocations never reach the upstream resource. Larger allocations are forwarded to upstream directly.
+//
+// Not thread safe, see synchronized_pool_resource.
+class unsynchronized_pool_resource : public memory_resource {
+  public:
+    using size_type = std::size_t;
+
+    explicit unsynchronized_pool_resource(memory_resource *upstream = get_default_resource())
+        : unsynchronized_pool_resource(pool_options{}, upstream) {}
+
+    unsynchronized_pool_resource(const pool_options &options, memory_resource *upstream = get_default_resource())
+        : m_upstream(upstream), m_options(normalize(options)) {
+        m_pools.reserve(pool_index(m_options.largest_required_pool_block) + 1);
+        for (size_type block_size = s_min_block_size; block_size <= m_options.largest_required_pool_block;
+             block_size *= 2) {
+            m_pools.push_back(pool{.block_size = block_size});
+        }
+    }
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource &other) = delete;
+    unsynchronized_pool_resource &operator=(const unsynchronized_pool_resource &other) = delete;
+    unsynchronized_pool_resource(unsynchronized_pool_resource &&other) = delete;
+    unsynchronized_pool_resource &operator=(unsynchronized_pool_resource &&other) = delete;
+
+    ~unsynchronized_pool_resource() override { release(); }
+
+    // Give all memory back to upstream, including blocks that are still in use
+    void release() noexcept {
+        for (auto &p : m_pools) {
+            while (p.chunks != nullptr) {
+                chunk *previous = p.chunks->previous;
+                m_upstream->deallocate(p.chunks->memory, p.chunks->size, p.block_size);
+                m_upstream->deallocate(p.chunks, sizeof(chunk), alignof(chunk));
+                p.chunks = previous;
+            }
+            p.free = nullptr;
+            p.next_chunk_blocks = s_min_blocks_per_chunk;
+        }
+
+        while (m_oversized != nullptr) {
+            oversized_header *next = m_oversized->next;
+            m_upstream->deallocate(m_oversized->memory, m_oversized->size, m_oversized->alignment);
+            m_oversized = next;
+        }
+    }
+
+    [[nodiscard]] memory_resource *upstream_resource() const noexcept { return m_upstream; }
+
+    [[nodiscard]] pool_options options() const noexcept { return m_options; }
+
+  private:
+    friend class synchronized_pool_resource;
+
+    struct free_block {
+        free_block *next;
+    };
+
+    struct chunk {
+        chunk *previous;
+        void *memory;
+        size_type size;
+    };
+
+    struct pool {
+        size_type block_size;
+        free_block *free{nullptr};
+        chunk *chunks{nullptr};
+        size_type next_chunk_blocks{s_min_blocks_per_chunk};
+    };
+
+    // Placed right before the memory handed out for every allocation too large for any pool. The headers form a doubly
+    // linked list so that `release` can find the allocations, and freeing one is O(1)
+    struct oversized_header {
+        oversized_header *previous;
+        oversized_header *next;
+        // What was allocated from upstream, including the header and any padding before it
+        void *memory;
+        size_type size;
+        size_type alignment;
+    };
+
+    static constexpr size_type s_min_block_size = 8;
+    static constexpr size_type s_min_blocks_per_chunk = 16;
+    static constexpr size_type s_default_max_blocks_per_chunk = 1024;
+    static constexpr size_type s_default_largest_pool_block = 4096;
+
+    [[nodiscard]] static pool_options normalize(pool_options options) noexcept {
+        if (options.max_blocks_per_chunk == 0) {
+            options.max_blocks_per_chunk = s_default_max_blocks_per_chunk;
+        }
+        options.max_blocks_per_chunk = std::max(options.max_blocks_per_chunk, s_min_blocks_per_chunk);
+
+        if (options.largest_required_pool_block == 0) {
+            options.largest_required_pool_block = s_default_largest_pool_block;
+        }
+        options.largest_required_pool_block =
+            std::bit_ceil(std::max(options.largest_required_pool_block, s_min_block_size));
+
+        return options;
+    }
+
+    // Index of the pool serving blocks of `size` bytes. Block sizes are powers of two and every block is aligned to its
+    // own size, so this also covers any alignment up to the block size
+    [[nodiscard]] static size_type pool_index(size_type size) noexcept {
+        return std::bit_width(std::bit_ceil(std::max(size, s_min_block_size))) -
+               std::bit_width(s_min_block_size);
+    }
+
+    void *do_allocate(size_type bytes, size_type alignment) override {
+        const size_type size = std::max(bytes, alignment);
+        if (size > m_options.largest_required_pool_block) {
+            return allocate_oversized(bytes, alignment);
+        }
+
+        pool &p = m_pools[pool_index(size)];
+        if (p.free == nullptr) {
+            allocate_chunk(p);
+        }
+
+        free_block *block = p.free;
+        p.free = block->next;
+        return block;
+    }
+
+    void do_deallocate(void *ptr, size_type bytes, size_type alignment) override {
+        const size_type size = std::max(bytes, alignment);
+        if (size > m_options.largest_required_pool_block) {
+            deallocate_oversized(ptr);
+            return;
+        }
+
+        pool &p = m_pools[pool_index(size)];
+        p.free = ::new (ptr) free_block{p.free};
+    }
+
+    [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override { return this == &other; }
+
+    void *allocate_oversized(size_type bytes, size_type alignment) {
+        // Alignments are powers of two, so rounding the offset up to one keeps the memory handed out aligned while
+        // leaving room for the header before it
+        const size_type offset = std::max(std::bit_ceil(sizeof(oversized_header)), alignment);
+        if (bytes > std::numeric_limits<size_type>::max() - offset) {
+            throw std::bad_alloc();
+        }
+
+        const size_type size = bytes + offset;
+        const size_type upstream_alignment = std::max(alignment, alignof(oversized_header));
+        auto *memory = static_cast<std::byte *>(m_upstream->allocate(size, upstream_alignment));
+        auto *header = ::new (memory + offset - sizeof(oversized_header)) oversized_header{
+            .previous = nullptr, .next = m_oversized, .memory = memory, .size = size, .alignment = upstream_alignment};
+
+        if (m_oversized != nullptr) {
+            m_oversized->previous = header;
+        }
+        m_oversized = header;
+        return header + 1;
+    }
+
+    void deallocate_oversized(void *ptr) noexcept {
+        auto *header = static_cast<oversized_header *>(ptr) - 1;
+        if (header->previous != nullptr) {
+            header->previous->next = header->next;
+        } else {
+            m_oversized = header->next;
+        }
+        if (header->next != nullptr) {
+            header->next->previous = header->previous;
+        }
+
+        m_upstream->deallocate(header->memory, header->size, header->alignment);
+    }
+
+    void allocate_chunk(pool &p) {
+        const size_type blocks = p.next_chunk_blocks;
+        const size_type size = blocks * p.block_size;
+
+        auto *header = static_cast<chunk *>(m_upstream->allocate(sizeof(chunk), alignof(chunk)));
+        void *memory = nullptr;
+        try {
+            memory = m_upstream->allocate(size, p.block_size);
+        } catch (...) {
+            m_upstream->deallocate(header, sizeof(chunk), alignof(chunk));
+            throw;
+        }
+        p.chunks = ::new (header) chunk{.previous = p.chunks, .memory = memory, .size = size};
+
+        auto *bytes = static_cast<std::byte *>(memory);
+        for (size_type i = blocks; i > 0; --i) {
+            p.free = ::new (bytes + ((i - 1) * p.block_size)) free_block{p.free};
+        }
+
+        p.next_chunk_blocks = std::min(blocks * 2, m_options.max_blocks_per_chunk);
+    }
+
+    memory_resource *m_upstream;
+    pool_options m_options;
+    nstd::vector<pool> m_pools;
+    oversized_header *m_oversized{nullptr};
+};
+
+// A thread safe unsynchronized_pool_resource. Each size class has its own lock, so threads allocating different sizes
+// don't contend with each other. The upstream resource may be called from several threads at once, so it needs to be
+// thread safe itself
+class synchronized_pool_resource : public memory_resource {
+  public:
+    using size_type = std::size_t;
+
+    explicit synchronized_pool_resource(memory_resource *upstream = get_default_resource())
+        : synchronized_pool_resource(pool_options{}, upstream) {}
+
+    synchronized_pool_resource(const pool_options &options, memory_resource *upstream = get_default_resource())
+        : m_pool(options, upstream), m_mutexes(new std::mutex[m_pool.m_pools.size() + 1]) {}
+
+    synchronized_pool_resource(const synchronized_pool_resource &other) = delete;
+    synchronized_pool_resource &operator=(const synchronized_pool_resource &other) = delete;
+    synchronized_pool_resource(synchronized_pool_resource &&other) = delete;
+    synchronized_pool_resource &operator=(synchronized_pool_resource &&other) = delete;
+
+    ~synchronized_pool_resource() override = default;
+
+    void release() {
+        const size_type n = m_pool.m_pools.size() + 1;
+        for (size_type i = 0; i < n; ++i) {
+            m_mutexes[i].lock();
+        }
+        m_pool.release();
+        for (size_type i = n; i > 0; --i) {
+            m_mutexes[i - 1].unlock();
+        }
+    }
+
+    [[nodiscard]] memory_resource *upstream_resource() const noexcept { return m_pool.upstream_resource(); }
+
+    [[nodiscard]] pool_options options() const noexcept { return m_pool.options(); }
+
+  private:
+    void *do_allocate(size_type bytes, size_type alignment) override {
+        std::scoped_lock lock(mutex_for(bytes, alignment));
+        return m_pool.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *ptr, size_type bytes, size_type alignment) override {
+        std::scoped_lock lock(mutex_for(bytes, alignment));
+        m_pool.deallocate(ptr, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override { return this == &other; }
+
+    // Each pool only touches its own free list and chunks, so it is enough to lock the size class being used. The
+    // last mutex guards the list of allocations too large for any pool
+    [[nodiscard]] std::mutex &mutex_for(size_type bytes, size_type alignment) noexcept {
+        const size_type size = std::max(bytes, alignment);
+        if (size > m_pool.m_options.largest_required_pool_block) {
+            return m_mutexes[m_pool.m_pools.size()];
+        }
+        return m_mutexes[unsynchronized_pool_resource::pool_index(size)];
+    }
+
+    unsynchronized_pool_resource m_pool;
+    nstd::unique_ptr<std::mutex[]> m_mutexes;
+};
+
+// A standard allocator that forwards to a memory_resource. The resource is picked when the allocator is constructed,
+// so all containers of the same element type share one type regardless of where their memory comes from
+template <typename T> class polymorphic_allocator {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    polymorphic_allocator() noexcept : m_resource(get_default_resource()) {}
+
+    // Implicit, so a memory_resource * can be passed anywhere an allocator is expected
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    polymorphic_allocator(memory_resource *resource) noexcept : m_resource(resource) { assert(m_resource); }
+
+    template <typename U>
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    polymorphic_allocator(const polymorphic_allocator<U> &other) noexcept : m_resource(other.resource()) {}
+
+    [[nodiscard]] T *allocate(size_type n) {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *ptr, size_type n) noexcept { m_resource->deallocate(ptr, n * sizeof(T), alignof(T)); }
+
+    // Allocates and constructs a single U, destroy with delete_object
+    template <typename U, typename... Args> [[nodiscard]] U *new_object(Args &&...args) {
+        void *memory = m_resource->allocate(sizeof(U), alignof(U));
+        try {
+            return ::new (memory) U{std::forward<Args>(args)...};
+        } catch (...) {
+            m_resource->deallocate(memory, sizeof(U), alignof(U));
+            throw;
+        }
+    }
+
+    template <typename U> void delete_object(U *ptr) noexcept {
+        ptr->~U();
+        m_resource->deallocate(ptr, sizeof(U), alignof(U));
+    }
+
+    [[nodiscard]] memory_resource *resource() const noexcept { return m_resource; }
+
+    // Copies of a container do not inherit the allocator, same as the STL. Otherwise a copy of a vector from a short
+    // lived arena would silently keep allocating from that arena
+    [[nodiscard]] polymorphic_allocator select_on_container_copy_construction() const noexcept { return {}; }
+
+  private:
+    memory_resource *m_resource;
+};
+
+template <typename T, typename U>
+[[nodiscard]] inline bool operator==(const polymorphic_allocator<T> &a, const polymorphic_allocator<U> &b) noexcept {
+    return *a.resource() == *b.resource();
+}
+
+template <typename T> using vector = nstd::vector<T, polymorphic_allocator<T>>;
+
+// Deleter for objects created by polymorphic_allocator::new_object. Remembers the resource the object came from
+template <typename T> struct resource_delete {
+    constexpr resource_delete() noexcept = default;
+
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    constexpr resource_delete(memory_resource *resource) noexcept : m_resource(resource) {}
+
+    void operator()(T *ptr) const noexcept {
+        if (ptr != nullptr) {
+            polymorphic_allocator<T>(m_resource).delete_object(ptr);
+        }
+    }
+
+    [[nodiscard]] memory_resource *resource() const noexcept { return m_resource; }
+
+  private:
+    memory_resource *m_resource{get_default_resource()};
+};
+
+template <typename T> using unique_ptr = nstd::unique_ptr<T, resource_delete<T>>;
+
+template <typename T, typename... Args>
+[[nodiscard]] unique_ptr<T> make_unique(memory_resource *resource, Args &&...args) {
+    polymorphic_allocator<T> allocator(resource);
+    return unique_ptr<T>(allocator.template new_object<T>(std::forward<Args>(args)...), resource_delete<T>(resource));
+}
+
+// The object is allocated from `resource`, the reference counts are still allocated with new
+template <typename T, typename... Args>
+[[nodiscard]] shared_ptr<T> make_shared(memory_resource *resource, Args &&...args) {
+    polymorphic_allocator<T> allocator(resource);
+    return shared_ptr<T>(allocator.template new_object<T>(std::forward<Args>(args)...), resource_delete<T>(resource));
+}
+
+} // namespace nstd::pmr
@@ -1,45 +1,60 @@
 #pragma once
 
+#include <compare>
+#include <cstddef>
 #include <iterator>
+#include <type_traits>
 
+// A thin wrapper around a pointer into a container's contiguous storage. Having a distinct type per container (rather
+// than just using the pointer) stops iterators from different container types from being mixed up.
+//
+// It models std::contiguous_iterator, so STL and ranges algorithms can see through it and use the same memmove and
+// vectorized fast paths they would use for raw pointers.
 template <typename Iterator, typename Container> struct normal_iterator {
   public:
     // Needed as traits for several STL functions
+    using iterator_type = Iterator;
+    using iterator_concept = std::contiguous_iterator_tag;
+    using iterator_category = typename std::iterator_traits<Iterator>::iterator_category;
     using value_type = typename std::iterator_traits<Iterator>::value_type;
+    // Used by std::pointer_traits, which std::to_address goes through. Keeps the constness of the pointee, unlike
+    // value_type
+    using element_type = std::remove_reference_t<typename std::iterator_traits<Iterator>::reference>;
     using reference = typename std::iterator_traits<Iterator>::reference;
     using pointer = typename std::iterator_traits<Iterator>::pointer;
     using difference_type = typename std::iterator_traits<Iterator>::difference_type;
-    using iterator_category = typename std::iterator_traits<Iterator>::iterator_category;
 
-    constexpr explicit normal_iterator(pointer ptr) : m_ptr(ptr) {}
+    constexpr normal_iterator() noexcept = default;
+
+    constexpr explicit normal_iterator(Iterator ptr) noexcept : m_ptr(ptr) {}
+
+    // Allows converting an iterator to a const_iterator of the same container, but not the other way around
+    template <typename Other>
+        requires std::is_convertible_v<Other, Iterator>
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    constexpr normal_iterator(const normal_iterator<Other, Container> &other) noexcept : m_ptr(other.base()) {}
+
+    [[nodiscard]] constexpr const Iterator &base() const noexcept { return m_ptr; }
 
     constexpr reference operator*() const noexcept { return *m_ptr; }
 
     constexpr pointer operator->() const noexcept { return m_ptr; }
 
+    constexpr reference operator[](difference_type n) const noexcept { return m_ptr[n]; }
+
     constexpr normal_iterator &operator++() noexcept {
         ++m_ptr;
         return *this;
     }
 
-    constexpr normal_iterator &operator++(int) noexcept {
-        normal_iterator &ret = *this;
-        ++m_ptr;
-        return ret;
-    }
+    constexpr normal_iterator operator++(int) noexcept { return normal_iterator{m_ptr++}; }
 
     constexpr normal_iterator &operator--() noexcept {
         --m_ptr;
         return *this;
     }
 
-    constexpr normal_iterator &operator--(int) noexcept {
-        normal_iterator &ret = *this;
-        --m_ptr;
-        return ret;
-    }
-
-    constexpr reference operator[](difference_type n) const noexcept { return m_ptr[n]; }
+    constexpr normal_iterator operator--(int) noexcept { return normal_iterator{m_ptr--}; }
 
     constexpr normal_iterator &operator-=(difference_type n) noexcept {
         m_ptr -= n;
@@ -53,16 +68,27 @@ template <typename Iterator, typename Container> struct normal_iterator {
 
     constexpr normal_iterator operator-(difference_type n) const noexcept { return normal_iterator{m_ptr - n}; }
 
-    constexpr difference_type operator-(const normal_iterator &other) const noexcept { return m_ptr - other.m_ptr; }
-
     constexpr normal_iterator operator+(difference_type n) const noexcept { return normal_iterator{m_ptr + n}; }
 
-    constexpr difference_type operator+(const normal_iterator &other) const noexcept { return m_ptr + other.m_ptr; }
+    friend constexpr normal_iterator operator+(difference_type n, const normal_iterator &it) noexcept { return it + n; }
 
-    constexpr bool operator==(const normal_iterator &other) const noexcept { return m_ptr == other.m_ptr; }
+    // The comparison operators are templates so that iterators and const_iterators of the same container can be
+    // compared and subtracted with each other
+    template <typename Other>
+    constexpr difference_type operator-(const normal_iterator<Other, Container> &other) const noexcept {
+        return m_ptr - other.base();
+    }
+
+    template <typename Other>
+    constexpr bool operator==(const normal_iterator<Other, Container> &other) const noexcept {
+        return m_ptr == other.base();
+    }
 
-    constexpr bool operator!=(const normal_iterator &other) const noexcept { return !((*this) == other); }
+    template <typename Other>
+    constexpr std::strong_ordering operator<=>(const normal_iterator<Other, Container> &other) const noexcept {
+        return m_ptr <=> other.base();
+    }
 
   private:
-    pointer m_ptr;
+    Iterator m_ptr{};
 };
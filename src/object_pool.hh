@@ -0,0 +1,251 @@
+#pragma once
+
+#include "unique_ptr.hh"
+#include "vector.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace nstd {
+
+// Process wide storage for fixed size slots of `Size` bytes aligned to `Alignment`. Slots are carved out of large
+// slabs and kept in an intrusive free list. Memory is never returned to the system before the program exits, so once
+// the pool has grown to fit the peak number of live objects no more allocations are needed.
+//
+// Threads don't use this directly, but go through a `size_class_cache` that moves slots to and from here in batches,
+// so the lock is only taken once per batch.
+template <std::size_t Size, std::size_t Alignment> class size_class_pool {
+  public:
+    using size_type = std::size_t;
+
+    // An intrusive singly linked list of free slots. The link is stored inside the free slot itself
+    struct free_slot {
+        free_slot *next;
+    };
+
+    struct free_chain {
+        free_slot *head{nullptr};
+        free_slot *tail{nullptr};
+        size_type size{0};
+    };
+
+    static constexpr size_type s_slot_size = Size;
+    static constexpr size_type s_slab_size = 64 * 1024;
+    static constexpr size_type s_slots_per_slab = std::max<size_type>(s_slab_size / s_slot_size, 1);
+
+    [[nodiscard]] static size_class_pool &instance() noexcept {
+        static size_class_pool pool;
+        return pool;
+    }
+
+    size_class_pool(const size_class_pool &other) = delete;
+    size_class_pool &operator=(const size_class_pool &other) = delete;
+    size_class_pool(size_class_pool &&other) = delete;
+    size_class_pool &operator=(size_class_pool &&other) = delete;
+
+    ~size_class_pool() noexcept {
+        for (auto *slab : m_slabs) {
+            ::operator delete(slab, std::align_val_t{Alignment});
+        }
+    }
+
+    // Take up to `n` free slots, allocating a new slab if there are none left. Never returns an empty chain
+    [[nodiscard]] free_chain take(size_type n) {
+        std::scoped_lock lock(m_mutex);
+        if (m_free.size == 0) {
+            allocate_slab();
+        }
+
+        free_chain ret{.head = m_free.head, .tail = m_free.head, .size = 1};
+        while (ret.size < n && ret.tail->next != nullptr) {
+            ret.tail = ret.tail->next;
+            ++ret.size;
+        }
+
+        m_free.head = ret.tail->next;
+        m_free.size -= ret.size;
+        if (m_free.head == nullptr) {
+            m_free.tail = nullptr;
+        }
+        ret.tail->next = nullptr;
+
+        return ret;
+    }
+
+    void give_back(free_chain chain) noexcept {
+        if (chain.size == 0) {
+            return;
+        }
+
+        std::scoped_lock lock(m_mutex);
+        chain.tail->next = m_free.head;
+        m_free.head = chain.head;
+        if (m_free.tail == nullptr) {
+            m_free.tail = chain.tail;
+        }
+        m_free.size += chain.size;
+    }
+
+    [[nodiscard]] size_type slab_count() noexcept {
+        std::scoped_lock lock(m_mutex);
+        return m_slabs.size();
+    }
+
+  private:
+    size_class_pool() noexcept = default;
+
+    void allocate_slab() {
+        m_slabs.reserve(m_slabs.size() + 1);
+        auto *slab =
+            static_cast<std::byte *>(::operator new(s_slots_per_slab * s_slot_size, std::align_val_t{Alignment}));
+        m_slabs.push_back(slab);
+
+        // Link the slots front to back, so consecutive allocations are next to each other in memory
+        auto *tail = ::new (slab + ((s_slots_per_slab - 1) * s_slot_size)) free_slot{nullptr};
+        free_slot *head = tail;
+        for (size_type i = s_slots_per_slab - 1; i > 0; --i) {
+            head = ::new (slab + ((i - 1) * s_slot_size)) free_slot{head};
+        }
+
+        m_free = free_chain{.head = head, .tail = tail, .size = s_slots_per_slab};
+    }
+
+    std::mutex m_mutex;
+    free_chain m_free{};
+    vector<std::byte *> m_slabs;
+};
+
+// A thread's private stash of free slots for one size class. Allocating and freeing only touches the global pool when
+// the stash runs empty or grows past twice the batch size, so in the steady state it is just a couple of pointer
+// operations with no locking
+template <std::size_t Size, std::size_t Alignment> class size_class_cache {
+  public:
+    using pool_type = size_class_pool<Size, Alignment>;
+    using size_type = std::size_t;
+    using free_slot = typename pool_type::free_slot;
+
+    // Number of slots moved between the cache and the global pool at once
+    static constexpr size_type s_batch_size = 32;
+
+    [[nodiscard]] static size_class_cache &local() noexcept {
+        thread_local size_class_cache cache;
+        return cache;
+    }
+
+    size_class_cache(const size_class_cache &other) = delete;
+    size_class_cache &operator=(const size_class_cache &other) = delete;
+    size_class_cache(size_class_cache &&other) = delete;
+    size_class_cache &operator=(size_class_cache &&other) = delete;
+
+    // Hand everything back to the global pool when the thread exits so other threads can reuse it
+    ~size_class_cache() noexcept { pool_type::instance().give_back(take_all()); }
+
+    [[nodiscard]] void *allocate() {
+        if (m_free.head == nullptr) {
+            m_free = pool_type::instance().take(s_batch_size);
+        }
+
+        free_slot *slot = m_free.head;
+        m_free.head = slot->next;
+        if (m_free.head == nullptr) {
+            m_free.tail = nullptr;
+        }
+        --m_free.size;
+
+        return slot;
+    }
+
+    void deallocate(void *ptr) noexcept {
+        auto *slot = ::new (ptr) free_slot{m_free.head};
+        if (m_free.head == nullptr) {
+            m_free.tail = slot;
+        }
+        m_free.head = slot;
+        ++m_free.size;
+
+        if (m_free.size >= 2 * s_batch_size) {
+            give_back_batch();
+        }
+    }
+
+  private:
+    size_class_cache() noexcept { static_cast<void>(pool_type::instance()); }
+
+    // Returns the oldest `s_batch_size` slots to the global pool, keeping the most recently freed (and most likely
+    // still cached) slots for ourselves
+    void give_back_batch() noexcept {
+        free_slot *last_kept = m_free.head;
+        for (size_type i = 1; i < m_free.size - s_batch_size; ++i) {
+            last_kept = last_kept->next;
+        }
+
+        typename pool_type::free_chain chain{.head = last_kept->next, .tail = m_free.tail, .size = s_batch_size};
+        last_kept->next = nullptr;
+        m_free.tail = last_kept;
+        m_free.size -= s_batch_size;
+
+        pool_type::instance().give_back(chain);
+    }
+
+    [[nodiscard]] typename pool_type::free_chain take_all() noexcept { return std::exchange(m_free, {}); }
+
+    typename pool_type::free_chain m_free{};
+};
+
+// Objects are grouped into size classes by rounding their size up to a multiple of this, so types of similar size share
+// slabs
+inline constexpr std::size_t s_pool_size_granularity = 16;
+
+template <typename T>
+using object_pool_cache =
+    size_class_cache<((std::max(sizeof(T), sizeof(void *)) + s_pool_size_granularity - 1) / s_pool_size_granularity) *
+                         s_pool_size_granularity,
+                     std::max(alignof(T), alignof(void *))>;
+
+// Deleter that destroys the object and returns its memory to the calling thread's pool cache instead of freeing it
+template <typename T> struct pool_delete {
+    constexpr pool_delete() noexcept = default;
+
+    void operator()(T *ptr) const noexcept {
+        if (ptr != nullptr) {
+            ptr->~T();
+            object_pool_cache<T>::local().deallocate(ptr);
+        }
+    }
+};
+
+// Hands out objects whose memory is recycled through per thread free lists instead of going through malloc and free.
+// An object may be released on a different thread than it was acquired on, in which case its memory moves to the
+// releasing thread's cache.
+//
+// The pool itself is stateless, all storage lives in the process wide size class pools, so object_pool instances are
+// free to create and a pool_delete adds no size to the unique_ptr.
+template <typename T> class object_pool {
+  public:
+    using size_type = std::size_t;
+    using deleter = pool_delete<T>;
+    using pointer = unique_ptr<T, deleter>;
+
+    constexpr object_pool() noexcept = default;
+
+    template <typename... Args> [[nodiscard]] pointer acquire(Args &&...args) const {
+        auto &cache = object_pool_cache<T>::local();
+        void *memory = cache.allocate();
+        try {
+            return pointer(::new (memory) T{std::forward<Args>(args)...});
+        } catch (...) {
+            cache.deallocate(memory);
+            throw;
+        }
+    }
+
+    // Number of slabs allocated for this type's size class, which is shared with other types of similar size
+    [[nodiscard]] size_type slab_count() const noexcept {
+        return object_pool_cache<T>::pool_type::instance().slab_count();
+    }
+};
+
+} // namespace nstd
@@ -0,0 +1,387 @@
+#pragma once
+
+#include "shared_ptr.hh"
+#include "vector.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <format>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace nstd {
+
+// A node in the trie of a persistent_vector. Inner nodes only use `children` and leaves only use `values`. Nodes are
+// shared between all the versions of a vector that have not modified them
+template <typename T> struct persistent_vector_node {
+    vector<shared_ptr<persistent_vector_node>> children;
+    vector<T> values;
+};
+
+template <typename T> class persistent_vector;
+
+// A mutable view of a persistent_vector used for batching updates. Any node that is only referenced by the transient
+// (use_count of 1) is modified in place, so only the first update along a path has to copy it. Pushing n elements
+// through a transient therefore costs roughly n / 32 node allocations instead of O(log n) per element.
+//
+// Call `persistent()` on an rvalue transient to turn it back into an immutable vector. A transient should not be shared
+// between threads.
+template <typename T> class transient_vector {
+  public:
+    using size_type = std::size_t;
+    using value_type = T;
+    using const_reference = const T &;
+    using rvalue_reference = T &&;
+
+    constexpr transient_vector() = default;
+
+    [[nodiscard]] constexpr size_type size() const noexcept { return m_size; }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] constexpr const_reference operator[](size_type i) const noexcept {
+        assert(i < m_size);
+        return leaf_for(i)[i & s_mask];
+    }
+
+    constexpr void push_back(const_reference x) { emplace_back(x); }
+
+    constexpr void push_back(rvalue_reference x) { emplace_back(std::move(x)); }
+
+    template <typename... Args> constexpr void emplace_back(Args &&...args) {
+        if (m_size - tail_offset() < s_branching) {
+            editable_tail().values.emplace_back(std::forward<Args>(args)...);
+            ++m_size;
+            return;
+        }
+
+        // The tail is full. The new tail and its element are made before the old tail is moved into the trie, so if
+        // either throws the transient is left as it was
+        shared_ptr<node> tail(new node());
+        tail->values.reserve(s_branching);
+        tail->values.emplace_back(std::forward<Args>(args)...);
+        push_tail();
+        m_tail = std::move(tail);
+        ++m_size;
+    }
+
+    constexpr void set(size_type i, const_reference x) { editable_leaf_for(i)[i & s_mask] = x; }
+
+    constexpr void set(size_type i, rvalue_reference x) { editable_leaf_for(i)[i & s_mask] = std::move(x); }
+
+    constexpr void pop_back() {
+        assert(!empty());
+        if (m_size == 1) {
+            *this = transient_vector();
+            return;
+        }
+
+        if (m_size - tail_offset() > 1) {
+            editable_tail().values.pop_back();
+            --m_size;
+            return;
+        }
+
+        // The tail only has one element left, so the rightmost leaf in the trie becomes the new tail
+        m_tail = leaf_node_for(m_size - 2);
+        if (pop_tail(m_shift, m_root)) {
+            m_root = shared_ptr<node>();
+        } else if (m_shift > s_bits && m_root->children.size() == 1) {
+            m_root = shared_ptr<node>(m_root->children[0]);
+            m_shift -= s_bits;
+        }
+        --m_size;
+    }
+
+    [[nodiscard]] constexpr persistent_vector<T> persistent() && {
+        persistent_vector<T> ret;
+        ret.m_state = std::move(*this);
+        *this = transient_vector();
+        return ret;
+    }
+
+  private:
+    friend class persistent_vector<T>;
+
+    using node = persistent_vector_node<T>;
+
+    // Each level of the trie consumes this many bits of the index
+    static constexpr size_type s_bits = 5;
+    static constexpr size_type s_branching = size_type{1} << s_bits;
+    static constexpr size_type s_mask = s_branching - 1;
+
+    // Index of the first element that is stored in the tail rather than the trie
+    [[nodiscard]] constexpr size_type tail_offset() const noexcept {
+        return m_size < s_branching ? 0 : ((m_size - 1) >> s_bits) << s_bits;
+    }
+
+    [[nodiscard]] constexpr const shared_ptr<node> &leaf_node_for(size_type i) const noexcept {
+        if (i >= tail_offset()) {
+            return m_tail;
+        }
+
+        const shared_ptr<node> *current = &m_root;
+        for (size_type level = m_shift; level > 0; level -= s_bits) {
+            current = &(*current)->children[(i >> level) & s_mask];
+        }
+        return *current;
+    }
+
+    [[nodiscard]] constexpr const vector<T> &leaf_for(size_type i) const noexcept { return leaf_node_for(i)->values; }
+
+    [[nodiscard]] constexpr vector<T> &editable_leaf_for(size_type i) {
+        if (i >= m_size) {
+            throw std::out_of_range(std::format("Index {} out of range for persistent_vector of size {}", i, m_size));
+        }
+
+        if (i >= tail_offset()) {
+            return editable_tail().values;
+        }
+
+        shared_ptr<node> *current = &m_root;
+        for (size_type level = m_shift; level > 0; level -= s_bits) {
+            current = &editable(*current).children[(i >> level) & s_mask];
+        }
+        return editable(*current).values;
+    }
+
+    // Make sure `ptr` is only referenced by this transient, copying the node if it is shared with other versions
+    static constexpr node &editable(shared_ptr<node> &ptr) {
+        if (ptr.use_count() > 1) {
+            ptr = shared_ptr<node>(new node(*ptr));
+        }
+        return *ptr;
+    }
+
+    // The tail is reserved up front so appending through a transient never has to reallocate it
+    constexpr node &editable_tail() {
+        if (!m_tail) {
+            m_tail = shared_ptr<node>(new node());
+            m_tail->values.reserve(s_branching);
+        } else if (m_tail.use_count() > 1) {
+            shared_ptr<node> tail(new node());
+            tail->values.reserve(s_branching);
+            for (const auto &x : m_tail->values) {
+                tail->values.push_back(x);
+            }
+            m_tail = std::move(tail);
+        }
+        return *m_tail;
+    }
+
+    // Create a chain of single child nodes down to `leaf`
+    [[nodiscard]] static constexpr shared_ptr<node> new_path(size_type level, const shared_ptr<node> &leaf) {
+        if (level == 0) {
+            return leaf;
+        }
+
+        shared_ptr<node> ret(new node());
+        ret->children.push_back(new_path(level - s_bits, leaf));
+        return ret;
+    }
+
+    // Adds the full tail to the trie, growing the trie by one level if it is full. Nodes are only made reachable once
+    // they are complete, so if this throws the trie still holds the same elements
+    constexpr void push_tail() {
+        if (!m_root) {
+            shared_ptr<node> root(new node());
+            root->children.push_back(m_tail);
+            m_root = std::move(root);
+            m_shift = s_bits;
+        } else if ((m_size >> s_bits) > (size_type{1} << m_shift)) {
+            shared_ptr<node> new_root(new node());
+            new_root->children.push_back(m_root);
+            new_root->children.push_back(new_path(m_shift, m_tail));
+            m_root = std::move(new_root);
+            m_shift += s_bits;
+        } else {
+            push_tail(m_shift, m_root);
+        }
+    }
+
+    constexpr void push_tail(size_type level, shared_ptr<node> &parent) {
+        node &editable_parent = editable(parent);
+        const size_type i = ((m_size - 1) >> level) & s_mask;
+
+        if (level == s_bits) {
+            editable_parent.children.push_back(m_tail);
+        } else if (i < editable_parent.children.size()) {
+            push_tail(level - s_bits, editable_parent.children[i]);
+        } else {
+            editable_parent.children.push_back(new_path(level - s_bits, m_tail));
+        }
+    }
+
+    // Removes the rightmost leaf from the trie. Returns whether `parent` became empty and should be removed as well
+    constexpr bool pop_tail(size_type level, shared_ptr<node> &parent) {
+        node &editable_parent = editable(parent);
+        const size_type i = ((m_size - 2) >> level) & s_mask;
+
+        if (level == s_bits || pop_tail(level - s_bits, editable_parent.children[i])) {
+            editable_parent.children.pop_back();
+        }
+
+        return editable_parent.children.empty();
+    }
+
+    shared_ptr<node> m_root{};
+    shared_ptr<node> m_tail{};
+    size_type m_size{0};
+    size_type m_shift{s_bits};
+};
+
+// An immutable vector where every modification returns a new version and leaves the original untouched. Versions
+// share structure through a 32-way trie, so a modification only copies the O(log32 n) nodes on the path to the
+// changed element, and appends mostly just copy a small tail buffer. Copying a persistent_vector is O(1).
+//
+// For many modifications in a row, use `transient()` to get a mutable builder that avoids copying the same path over
+// and over.
+template <typename T> class persistent_vector {
+  public:
+    using size_type = std::size_t;
+    using value_type = T;
+    using const_reference = const T &;
+    using rvalue_reference = T &&;
+    using transient_type = transient_vector<T>;
+
+    class const_iterator;
+
+    constexpr persistent_vector() = default;
+
+    constexpr persistent_vector(std::initializer_list<T> init) {
+        for (const auto &x : init) {
+            m_state.push_back(x);
+        }
+    }
+
+    [[nodiscard]] constexpr bool operator==(const persistent_vector &other) const {
+        return size() == other.size() && std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const persistent_vector &other) const { return !(*this == other); }
+
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return const_iterator{this, 0}; }
+
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin(); }
+
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return const_iterator{this, size()}; }
+
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] constexpr const_reference front() const noexcept {
+        assert(!empty());
+        return (*this)[0];
+    }
+
+    [[nodiscard]] constexpr const_reference back() const noexcept {
+        assert(!empty());
+        return (*this)[size() - 1];
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept { return m_state.size(); }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_state.empty(); }
+
+    [[nodiscard]] constexpr const_reference operator[](size_type i) const noexcept { return m_state[i]; }
+
+    [[nodiscard]] constexpr const_reference at(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range(std::format("Index {} out of range for persistent_vector of size {}", i, size()));
+        }
+        return (*this)[i];
+    }
+
+    [[nodiscard]] constexpr persistent_vector push_back(const_reference x) const { return emplace_back(x); }
+
+    [[nodiscard]] constexpr persistent_vector push_back(rvalue_reference x) const {
+        return emplace_back(std::move(x));
+    }
+
+    template <typename... Args> [[nodiscard]] constexpr persistent_vector emplace_back(Args &&...args) const {
+        auto ret = transient();
+        ret.emplace_back(std::forward<Args>(args)...);
+        return std::move(ret).persistent();
+    }
+
+    [[nodiscard]] constexpr persistent_vector set(size_type i, const_reference x) const {
+        auto ret = transient();
+        ret.set(i, x);
+        return std::move(ret).persistent();
+    }
+
+    [[nodiscard]] constexpr persistent_vector set(size_type i, rvalue_reference x) const {
+        auto ret = transient();
+        ret.set(i, std::move(x));
+        return std::move(ret).persistent();
+    }
+
+    [[nodiscard]] constexpr persistent_vector pop_back() const {
+        auto ret = transient();
+        ret.pop_back();
+        return std::move(ret).persistent();
+    }
+
+    // Creating a transient is O(1). It shares all nodes with this vector until it modifies them
+    [[nodiscard]] constexpr transient_type transient() const { return m_state; }
+
+  private:
+    friend class transient_vector<T>;
+
+    // The representation is the same as the transient's. It is just never modified in place
+    transient_type m_state{};
+};
+
+// Iterates the elements in order. Looks up the leaf holding the current element only once every 32 elements, so
+// iterating is O(n) rather than O(n log n)
+template <typename T> class persistent_vector<T>::const_iterator {
+  public:
+    using value_type = T;
+    using reference = const T &;
+    using pointer = const T *;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    constexpr const_iterator() noexcept = default;
+
+    constexpr const_iterator(const persistent_vector *owner, size_type i) noexcept : m_owner(owner), m_index(i) {
+        load_leaf();
+    }
+
+    constexpr reference operator*() const noexcept { return (*m_leaf)[m_index & transient_type::s_mask]; }
+
+    constexpr pointer operator->() const noexcept { return &**this; }
+
+    constexpr const_iterator &operator++() noexcept {
+        ++m_index;
+        if ((m_index & transient_type::s_mask) == 0) {
+            load_leaf();
+        }
+        return *this;
+    }
+
+    constexpr const_iterator operator++(int) noexcept {
+        const_iterator ret = *this;
+        ++*this;
+        return ret;
+    }
+
+    constexpr bool operator==(const const_iterator &other) const noexcept { return m_index == other.m_index; }
+
+    constexpr bool operator!=(const const_iterator &other) const noexcept { return !((*this) == other); }
+
+  private:
+    constexpr void load_leaf() noexcept {
+        if (m_index < m_owner->size()) {
+            m_leaf = &m_owner->m_state.leaf_for(m_index);
+        }
+    }
+
+    const persistent_vector *m_owner{nullptr};
+    const vector<T> *m_leaf{nullptr};
+    size_type m_index{0};
+};
+
+} // namespace nstd
@@ -1,68 +1,104 @@
 #pragma once
 
+#include "default_delete.hh"
+
 #include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace nstd {
 
-// TODO(gremble0): deleter template, maybe some allocator stuff elsewhere too
+// TODO(gremble0): maybe some allocator stuff elsewhere too
 class shared_count_base {
   public:
     constexpr shared_count_base() noexcept = default;
 
-    constexpr void add_reference() noexcept {
-        ++m_ref_count;
-        ++m_weak_count;
-    }
+    constexpr virtual ~shared_count_base() noexcept = default;
+
+    constexpr void add_reference() noexcept { ++m_ref_count; }
 
     constexpr void add_weak_reference() noexcept { ++m_weak_count; }
 
     constexpr void release() noexcept {
         if (--m_ref_count == 0) {
-            delete this;
+            dispose();
+            // All strong references together hold one weak reference, so the control block outlives the managed
+            // object for as long as there are weak references left
+            weak_release();
         }
-
-        --m_weak_count;
     }
 
-    constexpr void weak_release() noexcept { --m_weak_count; }
+    constexpr void weak_release() noexcept {
+        if (--m_weak_count == 0) {
+            delete this;
+        }
+    }
 
     [[nodiscard]] constexpr int64_t use_count() const noexcept { return m_ref_count; }
 
     shared_count_base(const shared_count_base &other) = delete;
     shared_count_base &operator=(const shared_count_base &other) = delete;
 
+  protected:
+    // Destroys the managed object. Called exactly once, when the last strong reference is released
+    constexpr virtual void dispose() noexcept = 0;
+
   private:
     // TODO(gremble0): maybe some smarter locking - here we have to lock and unlock twice when strong releasing
     std::atomic<int64_t> m_ref_count = 1;
     std::atomic<int64_t> m_weak_count = 1;
 };
 
+// Control block that destroys the managed object through a deleter, default_delete<T> unless a custom one is given
+template <typename T, typename Deleter> class shared_count_deleter final : public shared_count_base {
+  public:
+    // The deleter is moved exactly once, so if that throws the caller still has a deleter it can call
+    constexpr shared_count_deleter(T *ptr, Deleter &&deleter) noexcept(std::is_nothrow_move_constructible_v<Deleter>)
+        : m_deleter(std::move(deleter)), m_ptr(ptr) {}
+
+  protected:
+    constexpr void dispose() noexcept override { m_deleter(m_ptr); }
+
+  private:
+    [[no_unique_address]] Deleter m_deleter;
+    T *m_ptr;
+};
+
 class shared_count {
   public:
     constexpr shared_count() noexcept = default;
 
     constexpr explicit shared_count(shared_count_base *count) noexcept : m_count(count) { assert(m_count); }
 
-    constexpr shared_count(const shared_count &other) noexcept {
-        if (other.m_count != nullptr) {
-            m_count = other.m_count;
+    constexpr shared_count(const shared_count &other) noexcept : m_count(other.m_count) {
+        if (m_count != nullptr) {
             m_count->add_reference();
         }
     }
 
+    constexpr shared_count(shared_count &&other) noexcept : m_count(std::exchange(other.m_count, nullptr)) {}
+
     constexpr ~shared_count() noexcept {
         if (m_count) {
             m_count->release();
         }
     }
 
-    shared_count &operator=(const shared_count &other) = delete;
+    constexpr shared_count &operator=(const shared_count &other) noexcept {
+        shared_count(other).swap(*this);
+        return *this;
+    }
 
-    shared_count(shared_count &&other) = delete;
+    constexpr shared_count &operator=(shared_count &&other) noexcept {
+        shared_count(std::move(other)).swap(*this);
+        return *this;
+    }
 
-    shared_count &operator=(shared_count &&other) = delete;
+    constexpr void swap(shared_count &other) noexcept { std::swap(m_count, other.m_count); }
 
     [[nodiscard]] constexpr int64_t use_count() const noexcept { return m_count == nullptr ? 0 : m_count->use_count(); }
 
@@ -70,36 +106,84 @@ class shared_count {
     shared_count_base *m_count{nullptr};
 };
 
+// T may be an array type U[], in which case the shared_ptr manages a dynamically allocated array of U's and provides
+// indexing instead of operator* and operator->
 template <typename T> class shared_ptr {
   public:
-    using pointer = T *;
-
-    template <typename U, typename... Args> friend constexpr shared_ptr<U> make_shared(Args... args);
+    using element_type = std::remove_extent_t<T>;
+    using pointer = element_type *;
+    using size_type = std::size_t;
 
     constexpr shared_ptr() noexcept = default;
 
     constexpr ~shared_ptr() noexcept = default;
 
     // TODO(gremble0): noexcept
-    constexpr explicit shared_ptr(pointer ptr) : shared_ptr(ptr, shared_count{new shared_count_base}) {}
+    constexpr explicit shared_ptr(pointer ptr) : shared_ptr(ptr, default_delete<T>{}) {}
+
+    // The deleter is called with `ptr` once the last shared_ptr to it is destroyed, or right away if allocating the
+    // control block throws
+    template <typename Deleter>
+    constexpr shared_ptr(pointer ptr, Deleter deleter) : shared_ptr(ptr, make_count(ptr, deleter)) {}
 
     constexpr shared_ptr(const shared_ptr &other) noexcept = default;
 
-    // TODO(gremble0): these should not be deleted
-    constexpr shared_ptr(shared_ptr &&other) noexcept = delete;
-    constexpr shared_ptr &operator=(const shared_ptr &other) noexcept = delete;
-    constexpr shared_ptr &operator=(shared_ptr &&other) noexcept = delete;
+    constexpr shared_ptr(shared_ptr &&other) noexcept
+        : m_ptr(std::exchange(other.m_ptr, nullptr)), m_count(std::move(other.m_count)) {}
+
+    constexpr shared_ptr &operator=(const shared_ptr &other) noexcept {
+        shared_ptr(other).swap(*this);
+        return *this;
+    }
+
+    constexpr shared_ptr &operator=(shared_ptr &&other) noexcept {
+        shared_ptr(std::move(other)).swap(*this);
+        return *this;
+    }
 
     constexpr pointer get() const { return m_ptr; }
 
-    constexpr pointer operator->() const noexcept { return get(); }
+    constexpr pointer operator->() const noexcept
+        requires(!std::is_array_v<T>)
+    {
+        return get();
+    }
+
+    constexpr element_type &operator*() const noexcept
+        requires(!std::is_array_v<T>)
+    {
+        return *get();
+    }
 
-    constexpr T &operator*() const noexcept { return *get(); }
+    [[nodiscard]] constexpr element_type &operator[](size_type i) const noexcept
+        requires std::is_array_v<T>
+    {
+        return get()[i];
+    }
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept { return get() != nullptr; }
 
     [[nodiscard]] constexpr int64_t use_count() const noexcept { return m_count.use_count(); }
 
+    constexpr void reset() noexcept { shared_ptr().swap(*this); }
+
+    constexpr void swap(shared_ptr &other) noexcept {
+        std::swap(m_ptr, other.m_ptr);
+        m_count.swap(other.m_count);
+    }
+
   private:
-    // Used by make shared
+    template <typename Deleter> static constexpr shared_count make_count(pointer ptr, Deleter &deleter) {
+        try {
+            return shared_count{new shared_count_deleter<element_type, Deleter>{ptr, std::move(deleter)}};
+        } catch (...) {
+            // Same as std::shared_ptr, so that `ptr` does not leak. Either the allocation or the only move of `deleter`
+            // threw, so `deleter` was never moved from
+            deleter(ptr);
+            throw;
+        }
+    }
+
     constexpr explicit shared_ptr(pointer ptr, const shared_count &count) noexcept : m_ptr(ptr), m_count(count) {
         assert(m_ptr);
     }
@@ -108,8 +192,37 @@ template <typename T> class shared_ptr {
     shared_count m_count{};
 };
 
-template <typename T, typename... Args> constexpr shared_ptr<T> make_shared(Args... args) {
-    return shared_ptr(new T{std::forward<Args>(args)...}, shared_count{new shared_count_base});
+template <typename T, typename... Args>
+    requires(!std::is_array_v<T>)
+constexpr shared_ptr<T> make_shared(Args... args) {
+    return shared_ptr<T>(new T{std::forward<Args>(args)...});
+}
+
+// Creates an array of `n` value initialized elements, i.e. zeroed for trivial types
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+constexpr shared_ptr<T> make_shared(std::size_t n) {
+    return shared_ptr<T>(new std::remove_extent_t<T>[n]());
+}
+
+// See make_unique_for_overwrite
+template <typename T>
+    requires(!std::is_array_v<T>)
+constexpr shared_ptr<T> make_shared_for_overwrite() {
+    return shared_ptr<T>(new T);
+}
+
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+constexpr shared_ptr<T> make_shared_for_overwrite(std::size_t n) {
+    return shared_ptr<T>(new std::remove_extent_t<T>[n]);
+}
+
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+shared_ptr<T> make_shared_for_overwrite(std::size_t n, std::align_val_t alignment) {
+    using element_type = std::remove_extent_t<T>;
+    return shared_ptr<T>(allocate_aligned_for_overwrite<element_type>(n, alignment), aligned_delete<T>{n, alignment});
 }
 
 } // namespace nstd
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "growth.hh"
+#include "vector.hh"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace nstd {
+
+// Refers to an element of a slot_map. Stays valid until that element is erased, no matter what else is inserted or
+// erased, and is detected as stale afterwards instead of referring to whatever reuses the slot.
+//
+// A default constructed handle never refers to anything
+struct slot_map_handle {
+    static constexpr std::uint32_t s_invalid_index = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t index{s_invalid_index};
+    std::uint32_t generation{0};
+
+    [[nodiscard]] constexpr bool operator==(const slot_map_handle &other) const noexcept = default;
+};
+
+static_assert(sizeof(slot_map_handle) == sizeof(std::uint64_t));
+
+// A container that hands out handles to its elements, with O(1) insertion, erasure and lookup, and whose elements are
+// stored densely in a single `vector` so iterating over them is a linear scan.
+//
+// Erasing moves the last element into the erased element's place, so the order of the elements changes and references
+// and iterators to the last element are invalidated. Handles are the stable way to refer to elements.
+//
+// Each handle holds the index of a slot and the generation of the slot when the handle was made. A slot holds the
+// position of its element in the dense array, and its generation is bumped both when it is filled and when it is
+// emptied. Occupied slots therefore have odd generations, and a handle to an erased element no longer matches its
+// slot. After 2^31 reuses of the same slot the generation wraps around, and a very old handle may match again.
+template <typename T, typename Allocator = std::allocator<T>> class slot_map {
+  public:
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+    using value_type = T;
+    using reference = T &;
+    using const_reference = const T &;
+    using rvalue_reference = T &&;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using handle = slot_map_handle;
+    using values_type = vector<T, Allocator>;
+    using iterator = typename values_type::iterator;
+    using const_iterator = typename values_type::const_iterator;
+
+    constexpr slot_map() = default;
+
+    constexpr explicit slot_map(const allocator_type &allocator)
+        : m_values(allocator), m_dense_to_slot(index_allocator_type(allocator)),
+          m_slots(slot_allocator_type(allocator)) {}
+
+    [[nodiscard]] constexpr iterator begin() noexcept { return m_values.begin(); }
+
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return m_values.begin(); }
+
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return m_values.cbegin(); }
+
+    [[nodiscard]] constexpr iterator end() noexcept { return m_values.end(); }
+
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return m_values.end(); }
+
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return m_values.cend(); }
+
+    [[nodiscard]] constexpr pointer data() noexcept { return m_values.data(); }
+
+    [[nodiscard]] constexpr const_pointer data() const noexcept { return m_values.data(); }
+
+    [[nodiscard]] constexpr size_type size() const noexcept { return m_values.size(); }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_values.empty(); }
+
+    [[nodiscard]] constexpr bool contains(handle h) const noexcept {
+        // Only occupied slots have odd generations, so this also rejects made up handles to free slots
+        return h.index < m_slots.size() && m_slots[h.index].generation == h.generation && h.generation % 2 == 1;
+    }
+
+    // Returns a pointer to the element `h` refers to, or nullptr if it has been erased
+    [[nodiscard]] constexpr pointer get(handle h) noexcept { return contains(h) ? &m_values[dense_index(h)] : nullptr; }
+
+    [[nodiscard]] constexpr const_pointer get(handle h) const noexcept {
+        return contains(h) ? &m_values[dense_index(h)] : nullptr;
+    }
+
+    // Undefined behavior if `h` does not refer to an element. Use get or at when that is not known
+    [[nodiscard]] constexpr reference operator[](handle h) noexcept {
+        assert(contains(h));
+        return m_values[dense_index(h)];
+    }
+
+    [[nodiscard]] constexpr const_reference operator[](handle h) const noexcept {
+        assert(contains(h));
+        return m_values[dense_index(h)];
+    }
+
+    [[nodiscard]] constexpr reference at(handle h) {
+        handle_check(h);
+        return (*this)[h];
+    }
+
+    [[nodiscard]] constexpr const_reference at(handle h) const {
+        handle_check(h);
+        return (*this)[h];
+    }
+
+    // The handle of the i-th element in iteration order
+    [[nodiscard]] constexpr handle handle_at(size_type i) const noexcept {
+        const std::uint32_t slot_index = m_dense_to_slot[i];
+        return {.index = slot_index, .generation = m_slots[slot_index].generation};
+    }
+
+    constexpr handle insert(const_reference x) { return emplace(x); }
+
+    constexpr handle insert(rvalue_reference x) { return emplace(std::move(x)); }
+
+    template <typename... Args> constexpr handle emplace(Args &&...args) {
+        // Everything that can throw happens before any bookkeeping is changed, so a failed insertion leaves the map as
+        // it was, apart from possibly some extra capacity
+        if (m_free_head == handle::s_invalid_index) {
+            add_free_slot();
+        }
+        reserve_one(m_dense_to_slot);
+        m_values.emplace_back(std::forward<Args>(args)...);
+
+        const std::uint32_t slot_index = m_free_head;
+        auto &filled = m_slots[slot_index];
+        m_free_head = filled.dense_index_or_next_free;
+        filled.dense_index_or_next_free = static_cast<std::uint32_t>(m_values.size() - 1);
+        ++filled.generation;
+        m_dense_to_slot.push_back(slot_index);
+
+        return {.index = slot_index, .generation = filled.generation};
+    }
+
+    // Erases the element `h` refers to by moving the last element into its place. Returns false if `h` did not refer
+    // to an element
+    constexpr bool erase(handle h) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        if (!contains(h)) {
+            return false;
+        }
+
+        const std::uint32_t erased = m_slots[h.index].dense_index_or_next_free;
+        const auto last = static_cast<std::uint32_t>(m_values.size() - 1);
+        if (erased != last) {
+            m_values[erased] = std::move(m_values[last]);
+            m_dense_to_slot[erased] = m_dense_to_slot[last];
+            m_slots[m_dense_to_slot[erased]].dense_index_or_next_free = erased;
+        }
+        m_values.pop_back();
+        m_dense_to_slot.pop_back();
+
+        auto &emptied = m_slots[h.index];
+        ++emptied.generation;
+        emptied.dense_index_or_next_free = std::exchange(m_free_head, h.index);
+
+        return true;
+    }
+
+    // Erases every element. Handles to them become stale, but the slots are kept for reuse
+    constexpr void clear() noexcept {
+        for (size_type i = 0; i < size(); ++i) {
+            const std::uint32_t slot_index = m_dense_to_slot[i];
+            auto &emptied = m_slots[slot_index];
+            ++emptied.generation;
+            emptied.dense_index_or_next_free = std::exchange(m_free_head, slot_index);
+        }
+        m_values.clear();
+        m_dense_to_slot.clear();
+    }
+
+  private:
+    struct slot {
+        // The position of the element in m_values when the slot is occupied, or the next free slot when it is not
+        std::uint32_t dense_index_or_next_free;
+        std::uint32_t generation;
+    };
+
+    using index_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint32_t>;
+    using slot_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+
+    // The capacity the index and slot vectors start with
+    static constexpr size_type s_default_capacity = 8;
+
+    [[nodiscard]] constexpr std::uint32_t dense_index(handle h) const noexcept {
+        return m_slots[h.index].dense_index_or_next_free;
+    }
+
+    template <typename Vector> static constexpr void reserve_one(Vector &vec) {
+        if (vec.size() == vec.capacity()) {
+            vec.reserve(detail::grow_capacity(vec.capacity(), vec.size() + 1, s_default_capacity));
+        }
+    }
+
+    constexpr void add_free_slot() {
+        if (m_slots.size() >= handle::s_invalid_index) {
+            throw std::length_error(std::format("slot_map cannot hold more than {} elements", handle::s_invalid_index));
+        }
+
+        m_slots.push_back({.dense_index_or_next_free = m_free_head, .generation = 0});
+        m_free_head = static_cast<std::uint32_t>(m_slots.size() - 1);
+    }
+
+    constexpr void handle_check(handle h) const {
+        if (!contains(h)) {
+            throw std::out_of_range(
+                std::format("Handle with index {} and generation {} does not refer to an element of slot_map",
+                            h.index, h.generation));
+        }
+    }
+
+    values_type m_values;
+    // The slot of each element in m_values, for fixing up the slot of the element that is moved by erase
+    vector<std::uint32_t, index_allocator_type> m_dense_to_slot;
+    vector<slot, slot_allocator_type> m_slots;
+    // Head of the list of free slots, linked through dense_index_or_next_free
+    std::uint32_t m_free_head{handle::s_invalid_index};
+};
+
+} // namespace nstd
+
+template <> struct std::hash<nstd::slot_map_handle> {
+    [[nodiscard]] std::size_t operator()(const nstd::slot_map_handle &h) const noexcept {
+        return std::hash<std::uint64_t>{}((static_cast<std::uint64_t>(h.generation) << 32) | h.index);
+    }
+};
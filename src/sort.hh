@@ -0,0 +1,298 @@
+#pragma once
+
+#include "unique_ptr.hh"
+#include "vector.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace nstd {
+
+namespace detail {
+
+// Keys that can be mapped to an unsigned integer with the same ordering, which is what radix sort works on. Integers
+// wider than 64 bits, like __int128 in GNU mode, are left to the comparison sort
+template <typename T>
+concept radix_key = (std::integral<T> && !std::same_as<T, bool> && sizeof(T) <= 8) ||
+                    (std::floating_point<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+// The type of the key `KeyFn` gives for a T. Invoking a member pointer gives a reference to the member, so references
+// and qualifiers are stripped
+template <typename T, typename KeyFn>
+using sort_key_t = std::remove_cvref_t<std::invoke_result_t<KeyFn &, const T &>>;
+
+template <std::size_t Size>
+using radix_unsigned =
+    std::conditional_t<Size == 1, std::uint8_t,
+                       std::conditional_t<Size == 2, std::uint16_t,
+                                          std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+// Maps `key` to an unsigned integer that compares the same way. Signed integers get their sign bit flipped. Negative
+// floats get all their bits flipped, so larger magnitudes come first, and positive floats get their sign bit set, so
+// they come after all negative floats.
+//
+// This orders -0.0 before +0.0 and puts NaNs at either end depending on their sign bit. Neither matters for a
+// comparison sort, which would consider the zeros equal and has no defined behavior with NaNs at all
+template <radix_key T> [[nodiscard]] constexpr auto to_radix(T key) noexcept {
+    using unsigned_type = radix_unsigned<sizeof(T)>;
+    constexpr auto sign_bit =
+        static_cast<unsigned_type>(unsigned_type{1} << (std::numeric_limits<unsigned_type>::digits - 1));
+
+    if constexpr (std::floating_point<T>) {
+        const auto bits = std::bit_cast<unsigned_type>(key);
+        return static_cast<unsigned_type>((bits & sign_bit) != 0 ? ~bits : bits | sign_bit);
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<unsigned_type>(static_cast<unsigned_type>(key) ^ sign_bit);
+    } else {
+        return static_cast<unsigned_type>(key);
+    }
+}
+
+// Each radix pass sorts by one byte of the key
+inline constexpr std::size_t s_radix_bits = 8;
+inline constexpr std::size_t s_radix_buckets = std::size_t{1} << s_radix_bits;
+// Below this many elements the histograms cost more than a comparison sort
+inline constexpr std::size_t s_radix_threshold = 256;
+// Below this many elements starting threads costs more than it saves
+inline constexpr std::size_t s_parallel_radix_threshold = std::size_t{1} << 16;
+
+using radix_counts = std::array<std::size_t, s_radix_buckets>;
+
+template <typename Unsigned> [[nodiscard]] constexpr std::size_t radix_digit(Unsigned key, std::size_t digit) noexcept {
+    return static_cast<std::size_t>(key >> (digit * s_radix_bits)) & (s_radix_buckets - 1);
+}
+
+// Turns bucket counts into the index each bucket starts at
+constexpr void exclusive_prefix_sum(radix_counts &counts) noexcept {
+    std::size_t sum = 0;
+    for (auto &count : counts) {
+        sum += std::exchange(count, sum);
+    }
+}
+
+// Uninitialized storage for the elements that are being moved between radix passes, allocated from the allocator of
+// the vector being sorted
+template <typename Allocator> class radix_scratch {
+  public:
+    using allocator_traits = std::allocator_traits<Allocator>;
+    using pointer = typename allocator_traits::pointer;
+
+    radix_scratch(const Allocator &allocator, std::size_t n)
+        : m_allocator(allocator), m_data(allocator_traits::allocate(m_allocator, n)), m_size(n) {}
+
+    ~radix_scratch() noexcept { allocator_traits::deallocate(m_allocator, m_data, m_size); }
+
+    radix_scratch(const radix_scratch &other) = delete;
+    radix_scratch &operator=(const radix_scratch &other) = delete;
+    radix_scratch(radix_scratch &&other) = delete;
+    radix_scratch &operator=(radix_scratch &&other) = delete;
+
+    [[nodiscard]] pointer data() const noexcept { return m_data; }
+
+  private:
+    [[no_unique_address]] Allocator m_allocator;
+    pointer m_data;
+    std::size_t m_size;
+};
+
+// Stable LSD radix sort of [first, first + n) by `key`, using `scratch` as a buffer of n elements. T is trivially
+// copyable, so moving elements back and forth between the buffers is just copying bytes.
+//
+// The histograms for every digit are built in a single pass up front. A digit that is the same for every element would
+// leave the order unchanged, so its pass is skipped entirely, which is common for keys with a small range
+template <typename T, typename KeyFn> void radix_sort(T *first, T *scratch, std::size_t n, KeyFn &key) {
+    using key_type = decltype(to_radix(std::declval<sort_key_t<T, KeyFn>>()));
+    constexpr std::size_t digits = sizeof(key_type);
+
+    std::array<radix_counts, digits> counts{};
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto radix = to_radix(std::invoke(key, first[i]));
+        for (std::size_t digit = 0; digit < digits; ++digit) {
+            ++counts[digit][radix_digit(radix, digit)];
+        }
+    }
+
+    T *from = first;
+    T *to = scratch;
+    for (std::size_t digit = 0; digit < digits; ++digit) {
+        auto &offsets = counts[digit];
+        if (offsets[radix_digit(to_radix(std::invoke(key, *from)), digit)] == n) {
+            continue;
+        }
+
+        exclusive_prefix_sum(offsets);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::construct_at(to + offsets[radix_digit(to_radix(std::invoke(key, from[i])), digit)]++, from[i]);
+        }
+        std::swap(from, to);
+    }
+
+    if (from != first) {
+        std::copy_n(from, n, first);
+    }
+}
+
+// Runs `fn(thread, begin, end)` for `threads` roughly equal chunks of [0, n), one chunk per thread. The calling thread
+// takes the first chunk itself
+template <typename Fn> void for_each_chunk(std::size_t n, std::size_t threads, Fn &fn) {
+    const std::size_t chunk = (n + threads - 1) / threads;
+    vector<std::jthread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t thread = 1; thread < threads; ++thread) {
+        workers.emplace_back(
+            [&fn, thread, chunk, n] { fn(thread, std::min(n, thread * chunk), std::min(n, (thread + 1) * chunk)); });
+    }
+    fn(0, 0, std::min(n, chunk));
+    // The destructors of the workers join them
+}
+
+// Same as radix_sort, but each pass is split between `threads` threads. Every thread counts the digits in its own
+// chunk, and the per thread counts are combined so that each thread knows where in the output its elements of each
+// bucket go. The threads then scatter their chunks independently of each other.
+//
+// Unlike radix_sort the histograms have to be rebuilt for every pass, since the chunks hold different elements after
+// each pass
+template <typename T, typename KeyFn>
+void parallel_radix_sort(T *first, T *scratch, std::size_t n, KeyFn &key, std::size_t threads) {
+    using key_type = decltype(to_radix(std::declval<sort_key_t<T, KeyFn>>()));
+    constexpr std::size_t digits = sizeof(key_type);
+
+    auto counts = make_unique<radix_counts[]>(threads);
+    T *from = first;
+    T *to = scratch;
+    for (std::size_t digit = 0; digit < digits; ++digit) {
+        auto count = [&](std::size_t thread, std::size_t begin, std::size_t end) {
+            auto &local = counts[thread];
+            local.fill(0);
+            for (std::size_t i = begin; i < end; ++i) {
+                ++local[radix_digit(to_radix(std::invoke(key, from[i])), digit)];
+            }
+        };
+        for_each_chunk(n, threads, count);
+
+        // If every element has the same digit this pass would not change anything
+        const std::size_t first_bucket = radix_digit(to_radix(std::invoke(key, *from)), digit);
+        std::size_t first_bucket_count = 0;
+        for (std::size_t thread = 0; thread < threads; ++thread) {
+            first_bucket_count += counts[thread][first_bucket];
+        }
+        if (first_bucket_count == n) {
+            continue;
+        }
+
+        // Bucket by bucket, the elements of thread 0 go first, then those of thread 1 and so on. This keeps the sort
+        // stable, since the chunks are in order
+        std::size_t sum = 0;
+        for (std::size_t bucket = 0; bucket < s_radix_buckets; ++bucket) {
+            for (std::size_t thread = 0; thread < threads; ++thread) {
+                sum += std::exchange(counts[thread][bucket], sum);
+            }
+        }
+
+        auto scatter = [&](std::size_t thread, std::size_t begin, std::size_t end) {
+            auto &offsets = counts[thread];
+            for (std::size_t i = begin; i < end; ++i) {
+                std::construct_at(to + offsets[radix_digit(to_radix(std::invoke(key, from[i])), digit)]++, from[i]);
+            }
+        };
+        for_each_chunk(n, threads, scatter);
+        std::swap(from, to);
+    }
+
+    if (from != first) {
+        std::copy_n(from, n, first);
+    }
+}
+
+template <typename T, typename KeyFn>
+concept radix_sortable_by = std::is_trivially_copyable_v<T> && radix_key<sort_key_t<T, KeyFn>>;
+
+struct identity_key {
+    template <typename T> [[nodiscard]] constexpr T operator()(T x) const noexcept { return x; }
+};
+
+template <typename T, typename Allocator, typename KeyFn>
+constexpr void stable_sort_by_key(vector<T, Allocator> &vec, KeyFn &key) {
+    std::stable_sort(vec.begin(), vec.end(),
+                     [&key](const T &a, const T &b) { return std::invoke(key, a) < std::invoke(key, b); });
+}
+
+} // namespace detail
+
+// Sorts `vec` in ascending order. Vectors of integers and floats are sorted with an LSD radix sort, which does a fixed
+// number of linear passes over the data instead of O(n log n) comparisons. Everything else, and small vectors, are
+// sorted with std::sort.
+//
+// Radix sort needs a scratch buffer as large as the vector, which is allocated from the vector's allocator
+template <typename T, typename Allocator> constexpr void sort(vector<T, Allocator> &vec) {
+    if constexpr (detail::radix_key<T>) {
+        if !consteval {
+            if (vec.size() >= detail::s_radix_threshold) {
+                detail::identity_key key;
+                detail::radix_scratch<Allocator> scratch(vec.get_allocator(), vec.size());
+                detail::radix_sort(vec.data(), std::to_address(scratch.data()), vec.size(), key);
+                return;
+            }
+        }
+    }
+
+    std::sort(vec.begin(), vec.end());
+}
+
+// Sorts `vec` in ascending order of `key(element)`, keeping equal elements in their original order. `key` can be
+// anything std::invoke accepts, e.g. a pointer to a data member.
+//
+// When the elements are trivially copyable and the keys are integers or floats this is a stable LSD radix sort, which
+// makes it a good fit for sorting key-value pairs. Otherwise it falls back to std::stable_sort
+template <typename T, typename Allocator, typename KeyFn>
+constexpr void sort_by_key(vector<T, Allocator> &vec, KeyFn key) {
+    if constexpr (detail::radix_sortable_by<T, KeyFn>) {
+        if !consteval {
+            if (vec.size() >= detail::s_radix_threshold) {
+                detail::radix_scratch<Allocator> scratch(vec.get_allocator(), vec.size());
+                detail::radix_sort(vec.data(), std::to_address(scratch.data()), vec.size(), key);
+                return;
+            }
+        }
+    }
+
+    detail::stable_sort_by_key(vec, key);
+}
+
+// Same as sort_by_key, but the radix passes are split between `threads` threads. Only worth it for large vectors, so
+// smaller ones are sorted on the calling thread. `key` is called concurrently from several threads and must not throw
+template <typename T, typename Allocator, typename KeyFn>
+void parallel_sort_by_key(vector<T, Allocator> &vec, KeyFn key,
+                          std::size_t threads = std::thread::hardware_concurrency()) {
+    if constexpr (detail::radix_sortable_by<T, KeyFn>) {
+        if (threads > 1 && vec.size() >= detail::s_parallel_radix_threshold) {
+            detail::radix_scratch<Allocator> scratch(vec.get_allocator(), vec.size());
+            detail::parallel_radix_sort(vec.data(), std::to_address(scratch.data()), vec.size(), key, threads);
+            return;
+        }
+    }
+
+    sort_by_key(vec, std::move(key));
+}
+
+// Same as sort, but the radix passes are split between `threads` threads
+template <typename T, typename Allocator>
+void parallel_sort(vector<T, Allocator> &vec, std::size_t threads = std::thread::hardware_concurrency()) {
+    if constexpr (detail::radix_key<T>) {
+        parallel_sort_by_key(vec, detail::identity_key{}, threads);
+    } else {
+        std::sort(vec.begin(), vec.end());
+    }
+}
+
+} // namespace nstd
@@ -0,0 +1,343 @@
+#pragma once
+
+#include "growth.hh"
+#include "normal_iterator.hh"
+
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace nstd {
+
+// A string of chars with the small string optimization: strings of up to 22 chars are stored inside the object itself
+// instead of on the heap, so short keys and names never allocate. The object is 24 bytes, the same as a
+// `vector<char>`. Unlike std::basic_string only `char` is supported.
+//
+// Like std::string the characters are always followed by a null terminator, so `c_str` is free.
+//
+// Unlike the other containers this is not constexpr. Telling a short string from a long one means reading the flag
+// through whichever union member is not active, which is allowed through the common initial sequence but not in
+// constant expressions.
+template <typename Allocator = std::allocator<char>> class basic_string {
+  public:
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+    using value_type = char;
+    using reference = char &;
+    using const_reference = const char &;
+    using pointer = char *;
+    using const_pointer = const char *;
+    using iterator = normal_iterator<pointer, basic_string>;
+    using const_iterator = normal_iterator<const_pointer, basic_string>;
+    using traits_type = std::char_traits<char>;
+
+    basic_string() noexcept = default;
+
+    explicit basic_string(const allocator_type &allocator) noexcept : m_allocator(allocator) {}
+
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    basic_string(const char *str) : basic_string(std::string_view(str)) {}
+
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    basic_string(std::string_view str) { append(str); }
+
+    basic_string(size_type count, char ch) { append(count, ch); }
+
+    ~basic_string() noexcept {
+        if (is_long()) {
+            m_allocator.deallocate(m_rep.long_.data, m_rep.long_.capacity + 1);
+        }
+    }
+
+    basic_string(const basic_string &other)
+        : m_allocator(std::allocator_traits<allocator_type>::select_on_container_copy_construction(other.m_allocator)) {
+        if (other.is_long()) {
+            append(other.view());
+        } else {
+            m_rep = other.m_rep;
+        }
+    }
+
+    basic_string(basic_string &&other) noexcept
+        : m_allocator(std::exchange(other.m_allocator, allocator_type())), m_rep(std::exchange(other.m_rep, rep{})) {}
+
+    basic_string &operator=(const basic_string &other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        assign(other.view());
+
+        return *this;
+    }
+
+    basic_string &operator=(basic_string &&other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+
+        if (is_long()) {
+            m_allocator.deallocate(m_rep.long_.data, m_rep.long_.capacity + 1);
+        }
+
+        m_allocator = std::exchange(other.m_allocator, allocator_type());
+        m_rep = std::exchange(other.m_rep, rep{});
+
+        return *this;
+    }
+
+    basic_string &operator=(std::string_view str) { return assign(str); }
+
+    basic_string &operator=(const char *str) { return assign(str); }
+
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    [[nodiscard]] operator std::string_view() const noexcept { return view(); }
+
+    [[nodiscard]] std::string_view view() const noexcept { return {data(), size()}; }
+
+    // Comparisons take a string_view so that strings can be compared with each other, std::strings and literals alike
+    [[nodiscard]] bool operator==(std::string_view other) const noexcept { return view() == other; }
+
+    [[nodiscard]] std::strong_ordering operator<=>(std::string_view other) const noexcept { return view() <=> other; }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator{data()}; }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator{data()}; }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept { return const_iterator{data()}; }
+
+    [[nodiscard]] iterator end() noexcept { return iterator{data() + size()}; }
+
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator{data() + size()}; }
+
+    [[nodiscard]] const_iterator cend() const noexcept { return const_iterator{data() + size()}; }
+
+    [[nodiscard]] reference front() noexcept {
+        assert(!empty());
+        return *begin();
+    }
+
+    [[nodiscard]] const_reference front() const noexcept {
+        assert(!empty());
+        return *begin();
+    }
+
+    [[nodiscard]] reference back() noexcept {
+        assert(!empty());
+        return *(end() - 1);
+    }
+
+    [[nodiscard]] const_reference back() const noexcept {
+        assert(!empty());
+        return *(end() - 1);
+    }
+
+    [[nodiscard]] size_type size() const noexcept { return is_long() ? m_rep.long_.size : m_rep.short_.size; }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return is_long() ? m_rep.long_.capacity : s_short_capacity;
+    }
+
+    [[nodiscard]] const_pointer data() const noexcept {
+        return is_long() ? m_rep.long_.data : static_cast<const_pointer>(m_rep.short_.data);
+    }
+
+    [[nodiscard]] pointer data() noexcept {
+        return is_long() ? m_rep.long_.data : static_cast<pointer>(m_rep.short_.data);
+    }
+
+    [[nodiscard]] const_pointer c_str() const noexcept { return data(); }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_allocator; }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    // Whether the characters are stored inside the object rather than on the heap
+    [[nodiscard]] bool is_short() const noexcept { return !is_long(); }
+
+    void clear() noexcept { set_size(0); }
+
+    void reserve(size_type n) {
+        if (n > capacity()) {
+            reallocate(n);
+        }
+    }
+
+    [[nodiscard]] reference operator[](size_type i) noexcept { return data()[i]; }
+
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept { return data()[i]; }
+
+    [[nodiscard]] reference at(size_type i) {
+        range_check(i);
+        return (*this)[i];
+    }
+
+    [[nodiscard]] const_reference at(size_type i) const {
+        range_check(i);
+        return (*this)[i];
+    }
+
+    basic_string &assign(std::string_view str) {
+        if (str.size() > capacity()) {
+            // Nothing from the old contents is kept, but `str` may point into them so they are freed afterwards
+            basic_string copy(m_allocator);
+            copy.append(str);
+            *this = std::move(copy);
+        } else {
+            traits_type::move(data(), str.data(), str.size());
+            set_size(str.size());
+        }
+
+        return *this;
+    }
+
+    basic_string &append(std::string_view str) {
+        const size_type new_size = size() + str.size();
+        if (new_size > capacity()) {
+            // `str` may point into this string, so it has to be copied before the old buffer is freed
+            reallocate(detail::grow_capacity(capacity(), new_size, s_short_capacity), str);
+        } else {
+            traits_type::copy(data() + size(), str.data(), str.size());
+            set_size(new_size);
+        }
+
+        return *this;
+    }
+
+    basic_string &append(size_type count, char ch) {
+        const size_type old_size = size();
+        grow_for(old_size + count);
+        traits_type::assign(data() + old_size, count, ch);
+        set_size(old_size + count);
+
+        return *this;
+    }
+
+    basic_string &operator+=(std::string_view str) { return append(str); }
+
+    basic_string &operator+=(char ch) {
+        push_back(ch);
+        return *this;
+    }
+
+    void push_back(char ch) {
+        const size_type old_size = size();
+        grow_for(old_size + 1);
+        data()[old_size] = ch;
+        set_size(old_size + 1);
+    }
+
+    void pop_back() noexcept {
+        assert(!empty());
+        set_size(size() - 1);
+    }
+
+    void resize(size_type n, char ch = '\0') {
+        if (n > size()) {
+            append(n - size(), ch);
+        } else {
+            set_size(n);
+        }
+    }
+
+    // Resizes to `n` chars without initializing the new ones, for building a string in place through `data()` without
+    // writing everything twice. Every new char has to be written before it is read
+    void resize_for_overwrite(size_type n) {
+        grow_for(n);
+        set_size(n);
+    }
+
+  private:
+    // The flag is the first bit field of both representations, so it can be read through either of them regardless of
+    // which one is active
+    struct long_rep {
+        size_type is_long : 1;
+        size_type capacity : (sizeof(size_type) * 8) - 1;
+        size_type size;
+        pointer data;
+    };
+
+    struct short_rep {
+        size_type is_long : 1;
+        size_type size : 7;
+        char data[sizeof(long_rep) - 1];
+    };
+
+    union rep {
+        short_rep short_;
+        long_rep long_;
+    };
+
+    static_assert(sizeof(short_rep) == sizeof(long_rep), "The short representation should not make strings larger");
+
+    // The last char of the short representation is reserved for the null terminator
+    static constexpr size_type s_short_capacity = sizeof(short_rep::data) - 1;
+
+    [[nodiscard]] bool is_long() const noexcept { return m_rep.short_.is_long != 0; }
+
+    // Sets the size without touching the contents, apart from writing the null terminator
+    void set_size(size_type n) noexcept {
+        assert(n <= capacity());
+        if (is_long()) {
+            m_rep.long_.size = n;
+        } else {
+            m_rep.short_.size = n;
+        }
+        data()[n] = '\0';
+    }
+
+    void grow_for(size_type n) {
+        if (n > capacity()) {
+            reallocate(detail::grow_capacity(capacity(), n, s_short_capacity));
+        }
+    }
+
+    // Moves the contents to a heap buffer with room for `new_capacity` chars, and appends `suffix` to them. Strings
+    // never move back from the heap to the short representation
+    void reallocate(size_type new_capacity, std::string_view suffix = {}) {
+        const size_type old_size = size();
+        pointer new_data = m_allocator.allocate(new_capacity + 1);
+        traits_type::copy(new_data, data(), old_size);
+        traits_type::copy(new_data + old_size, suffix.data(), suffix.size());
+
+        if (is_long()) {
+            m_allocator.deallocate(m_rep.long_.data, m_rep.long_.capacity + 1);
+        }
+
+        m_rep.long_ = {.is_long = 1, .capacity = new_capacity, .size = 0, .data = new_data};
+        set_size(old_size + suffix.size());
+    }
+
+    void range_check(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range(std::format("Index {} out of range for string of size {}", i, size()));
+        }
+    }
+
+    [[no_unique_address]] allocator_type m_allocator{};
+    rep m_rep{};
+};
+
+using string = basic_string<>;
+
+} // namespace nstd
+
+template <typename Allocator> struct std::hash<nstd::basic_string<Allocator>> {
+    [[nodiscard]] std::size_t operator()(const nstd::basic_string<Allocator> &str) const noexcept {
+        return std::hash<std::string_view>{}(str.view());
+    }
+};
+
+template <typename Allocator>
+struct std::formatter<nstd::basic_string<Allocator>> : std::formatter<std::string_view> {
+    auto format(const nstd::basic_string<Allocator> &str, std::format_context &ctx) const {
+        return std::formatter<std::string_view>::format(str.view(), ctx);
+    }
+};
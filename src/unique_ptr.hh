@@ -1,16 +1,14 @@
 #pragma once
 
+#include "default_delete.hh"
+
 #include <cstddef>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace nstd {
 
-template <typename T> struct default_delete {
-    constexpr default_delete() noexcept = default;
-
-    constexpr void operator()(T *ptr) const { delete ptr; }
-};
-
 template <typename T, typename Deleter = default_delete<T>> class unique_ptr {
   public:
     using pointer = T *;
@@ -20,18 +18,18 @@ template <typename T, typename Deleter = default_delete<T>> class unique_ptr {
 
     constexpr explicit unique_ptr(pointer ptr) noexcept : m_ptr(ptr) {}
 
+    constexpr unique_ptr(pointer ptr, deleter d) noexcept : m_deleter(std::move(d)), m_ptr(ptr) {}
+
     unique_ptr(const unique_ptr &other) = delete;
 
     unique_ptr &operator=(const unique_ptr &other) = delete;
 
-    constexpr unique_ptr(unique_ptr &&other) noexcept {
-        reset(other.get());
-        other.m_ptr = nullptr;
-    }
+    constexpr unique_ptr(unique_ptr &&other) noexcept
+        : m_deleter(std::move(other.m_deleter)), m_ptr(other.release()) {}
 
     constexpr unique_ptr &operator=(unique_ptr &&other) noexcept {
-        reset(other.get());
-        other.m_ptr = nullptr;
+        reset(other.release());
+        m_deleter = std::move(other.m_deleter);
 
         return *this;
     }
@@ -63,8 +61,68 @@ template <typename T, typename Deleter = default_delete<T>> class unique_ptr {
     }
 
     constexpr void swap(unique_ptr &other) noexcept {
-        m_deleter = std::exchange(m_deleter, other.get_deleter());
-        m_ptr = std::exchange(m_ptr, other.get());
+        std::swap(m_deleter, other.m_deleter);
+        std::swap(m_ptr, other.m_ptr);
+    }
+
+  private:
+    [[no_unique_address]] deleter m_deleter{};
+    pointer m_ptr{nullptr};
+};
+
+// Specialization for dynamically sized arrays. Provides indexing instead of operator* and operator->
+template <typename T, typename Deleter> class unique_ptr<T[], Deleter> {
+  public:
+    using pointer = T *;
+    using deleter = Deleter;
+    using size_type = std::size_t;
+
+    constexpr unique_ptr() noexcept = default;
+
+    constexpr explicit unique_ptr(pointer ptr) noexcept : m_ptr(ptr) {}
+
+    constexpr unique_ptr(pointer ptr, deleter d) noexcept : m_deleter(std::move(d)), m_ptr(ptr) {}
+
+    unique_ptr(const unique_ptr &other) = delete;
+
+    unique_ptr &operator=(const unique_ptr &other) = delete;
+
+    constexpr unique_ptr(unique_ptr &&other) noexcept
+        : m_deleter(std::move(other.m_deleter)), m_ptr(other.release()) {}
+
+    constexpr unique_ptr &operator=(unique_ptr &&other) noexcept {
+        reset(other.release());
+        m_deleter = std::move(other.m_deleter);
+
+        return *this;
+    }
+
+    constexpr ~unique_ptr() { m_deleter(m_ptr); }
+
+    [[nodiscard]] constexpr pointer get() const { return m_ptr; }
+
+    [[nodiscard]] constexpr deleter get_deleter() const { return m_deleter; }
+
+    [[nodiscard]] constexpr T &operator[](size_type i) const noexcept { return get()[i]; }
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept { return get() != nullptr; }
+
+    constexpr void reset(pointer ptr) noexcept {
+        // See the comment in unique_ptr<T>::reset
+        pointer old_ptr = m_ptr;
+        m_ptr = ptr;
+        m_deleter(old_ptr);
+    }
+
+    constexpr pointer release() noexcept {
+        pointer ptr = m_ptr;
+        m_ptr = nullptr;
+        return ptr;
+    }
+
+    constexpr void swap(unique_ptr &other) noexcept {
+        std::swap(m_deleter, other.m_deleter);
+        std::swap(m_ptr, other.m_ptr);
     }
 
   private:
@@ -72,10 +130,42 @@ template <typename T, typename Deleter = default_delete<T>> class unique_ptr {
     pointer m_ptr{nullptr};
 };
 
-template <typename T, typename... Args> constexpr unique_ptr<T> make_unique(Args... args) {
+template <typename T, typename... Args>
+    requires(!std::is_array_v<T>)
+constexpr unique_ptr<T> make_unique(Args... args) {
     return unique_ptr(new T{std::forward<Args>(args)...});
 }
 
+// Creates an array of `n` value initialized elements, i.e. zeroed for trivial types
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+constexpr unique_ptr<T> make_unique(std::size_t n) {
+    return unique_ptr<T>(new std::remove_extent_t<T>[n]());
+}
+
+// The _for_overwrite variants default initialize instead of value initialize. For trivial types the memory is left
+// uninitialized, which avoids paying for zeroing memory that is going to be overwritten anyways, e.g. I/O buffers.
+template <typename T>
+    requires(!std::is_array_v<T>)
+constexpr unique_ptr<T> make_unique_for_overwrite() {
+    return unique_ptr<T>(new T);
+}
+
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+constexpr unique_ptr<T> make_unique_for_overwrite(std::size_t n) {
+    return unique_ptr<T>(new std::remove_extent_t<T>[n]);
+}
+
+// Like make_unique_for_overwrite, but the array is aligned to `alignment`. Useful for over-aligned SIMD buffers
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+unique_ptr<T, aligned_delete<T>> make_unique_for_overwrite(std::size_t n, std::align_val_t alignment) {
+    using element_type = std::remove_extent_t<T>;
+    return unique_ptr<T, aligned_delete<T>>(allocate_aligned_for_overwrite<element_type>(n, alignment),
+                                            aligned_delete<T>{n, alignment});
+}
+
 // The parameters have separate templated types because its necessary for types that may have some relation with
 // eachother, but that are not the same. E.g. comparing two unrelated types won't work anyways, but comparing two
 // classes related by inheritance will.
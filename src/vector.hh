@@ -1,5 +1,6 @@
 #pragma once
 
+#include "growth.hh"
 #include "normal_iterator.hh"
 
 #include <algorithm>
@@ -7,6 +8,7 @@
 #include <cstddef>
 #include <format>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <utility>
@@ -44,7 +46,8 @@ template <typename T, typename Allocator = std::allocator<T>> class vector {
         }
     }
 
-    constexpr vector(const vector &other) : m_allocator(other.get_allocator()) {
+    constexpr vector(const vector &other)
+        : m_allocator(std::allocator_traits<allocator_type>::select_on_container_copy_construction(other.m_allocator)) {
         range_initialize_n(other.begin(), other.size());
     }
 
@@ -64,10 +67,19 @@ template <typename T, typename Allocator = std::allocator<T>> class vector {
     }
 
     constexpr vector &operator=(vector &&other) noexcept {
-        m_allocator = std::exchange(other.get_allocator(), allocator_type());
-        m_data = std::exchange(other.data(), nullptr);
-        m_capacity = std::exchange(other.capacity(), 0);
-        m_size = std::exchange(other.size(), 0);
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+        if (m_data) {
+            m_allocator.deallocate(m_data, m_capacity);
+        }
+
+        m_allocator = std::exchange(other.m_allocator, allocator_type());
+        m_data = std::exchange(other.m_data, nullptr);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_size = std::exchange(other.m_size, 0);
 
         return *this;
     }
@@ -138,8 +150,8 @@ template <typename T, typename Allocator = std::allocator<T>> class vector {
         if (m_data) {
             // Regarding constexpr validity - same as usage of uninitialize_copy. Usage of this is not really constexpr
             // until c++26
-            std::uninitialized_move(begin(), end(), new_data);
-            std::destroy(begin(), end());
+            std::uninitialized_move(m_data, m_data + m_size, new_data);
+            std::destroy(m_data, m_data + m_size);
             m_allocator.deallocate(m_data, capacity());
         }
 
@@ -170,7 +182,7 @@ template <typename T, typename Allocator = std::allocator<T>> class vector {
     // constistent by making it void instead
     template <typename... Args> constexpr void emplace_back(Args &&...args) {
         if (m_size >= m_capacity) {
-            reserve(m_capacity == 0 ? s_default_capacity : m_capacity * s_growth_factor);
+            reserve(detail::grow_capacity(m_capacity, m_size + 1, s_default_capacity));
         }
 
         std::construct_at(&*end(), std::forward<Args>(args)...);
@@ -186,22 +198,30 @@ template <typename T, typename Allocator = std::allocator<T>> class vector {
   private:
     // This will be the capacity of a default initialized/empty vector
     static constexpr size_type s_default_capacity = 8;
-    // How much should the vector grow when it needs to resize?
-    static constexpr size_type s_growth_factor = 2;
 
-    constexpr void range_check(size_type i) {
+    constexpr void range_check(size_type i) const {
         if (i >= size()) {
             throw std::out_of_range(std::format("Index {} out of range for vector of size {}", i, m_size));
         }
     }
 
+    // The uninitialized_* algorithms only lower to memmove for trivially copyable types when they are given raw
+    // pointers, so contiguous iterators are unwrapped before being passed to them
+    template <typename FromIterator> static constexpr auto unwrap(FromIterator it) noexcept {
+        if constexpr (std::contiguous_iterator<FromIterator>) {
+            return std::to_address(it);
+        } else {
+            return it;
+        }
+    }
+
     // TODO(gremble0): conditional noexcept
     template <typename FromIterator> constexpr void range_initialize_n(FromIterator from_start, size_type n) {
         reserve(n);
         try {
             // uninitialized_copy_n is constexpr in c++26. With c++23 this constructor is not really constexpr, but I
             // will leave it like this for the future.
-            std::uninitialized_copy_n(from_start, n, begin());
+            std::uninitialized_copy_n(unwrap(from_start), n, m_data);
             m_size = n;
         } catch (...) {
             // We cannot know the type of what is thrown here since it can depend on user defined types. We just have to
@@ -218,7 +238,7 @@ template <typename T, typename Allocator = std::allocator<T>> class vector {
         try {
             // uninitialized_move_n is constexpr in c++26. With c++23 this constructor is not really constexpr, but I
             // will leave it like this for the future.
-            std::uninitialized_move_n(from_start, n, begin());
+            std::uninitialized_move_n(unwrap(from_start), n, m_data);
             m_size = n;
         } catch (...) {
             // We cannot know the type of what is thrown here since it can depend on user defined types. We just have to
@@ -0,0 +1,147 @@
+#include "compressed_int_vector.hh"
+#include "vector.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Checks every way of reading values back against `expected`
+bool matches(const nstd::compressed_int_vector<> &compressed, const nstd::vector<std::uint64_t> &expected) {
+    if (compressed.size() != expected.size()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        if (compressed[i] != expected[i]) {
+            return false;
+        }
+    }
+
+    std::size_t i = 0;
+    bool equal = true;
+    compressed.for_each([&](std::uint64_t x) { equal = equal && x == expected[i++]; });
+
+    return equal && compressed.to_vector() == expected;
+}
+
+// The number of allocations failing_allocator makes before it throws, or a negative number to never throw
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int allocations_left = -1;
+
+template <typename T> struct failing_allocator {
+    using value_type = T;
+
+    failing_allocator() = default;
+
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    template <typename U> constexpr failing_allocator(const failing_allocator<U> & /*other*/) noexcept {}
+
+    T *allocate(std::size_t n) {
+        if (allocations_left-- == 0) {
+            throw std::bad_alloc();
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept { std::allocator<T>{}.deallocate(ptr, n); }
+
+    [[nodiscard]] bool operator==(const failing_allocator & /*other*/) const noexcept = default;
+};
+
+} // namespace
+
+TEST_CASE("Test compressed_int_vector construction") {
+    nstd::compressed_int_vector empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty.size() == 0U);
+    REQUIRE(empty.to_vector().empty());
+
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp)
+    std::mt19937_64 engine(1);
+
+    SECTION("Test every width") {
+        for (std::size_t width = 0; width <= 64; ++width) {
+            const std::uint64_t max = width == 64 ? std::numeric_limits<std::uint64_t>::max() : (1ULL << width) - 1;
+            std::uniform_int_distribution<std::uint64_t> distribution(0, max);
+            const std::uint64_t base = width == 64 ? 0 : engine() >> width;
+
+            nstd::vector<std::uint64_t> values;
+            for (std::size_t i = 0; i < 300; ++i) {
+                values.push_back(base + distribution(engine));
+            }
+            // Makes sure the block actually needs all `width` bits
+            values.push_back(base);
+            values.push_back(base + max);
+
+            const nstd::compressed_int_vector compressed(values);
+            REQUIRE(matches(compressed, values));
+        }
+    }
+
+    SECTION("Test push_back") {
+        nstd::compressed_int_vector compressed;
+        nstd::vector<std::uint64_t> values;
+        for (std::uint64_t i = 0; i < 1000; ++i) {
+            const std::uint64_t x = (i * 1000) + (engine() % 1000);
+            compressed.push_back(x);
+            values.push_back(x);
+            REQUIRE(compressed.size() == values.size());
+            REQUIRE(compressed[i] == x);
+        }
+        REQUIRE(matches(compressed, values));
+    }
+}
+
+TEST_CASE("Test compressed_int_vector at") {
+    nstd::compressed_int_vector compressed(nstd::vector<std::uint64_t>{1, 2, 3});
+    REQUIRE(compressed.at(2) == 3U);
+    REQUIRE_THROWS_AS(compressed.at(3), std::out_of_range);
+}
+
+TEST_CASE("Test compressed_int_vector memory") {
+    // Sorted timestamps a few milliseconds apart need around 10 bits each instead of 64
+    nstd::vector<std::uint64_t> timestamps;
+    std::uint64_t timestamp = 1'700'000'000'000;
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp)
+    std::mt19937_64 engine(1);
+    for (std::size_t i = 0; i < 100000; ++i) {
+        timestamp += engine() % 8;
+        timestamps.push_back(timestamp);
+    }
+
+    const nstd::compressed_int_vector compressed(timestamps);
+    REQUIRE(matches(compressed, timestamps));
+
+    const auto memory = compressed.memory();
+    REQUIRE(memory.total() == memory.headers + memory.words + memory.pending);
+    REQUIRE(memory.total() * 4 < timestamps.size() * sizeof(std::uint64_t));
+}
+
+TEST_CASE("Test compressed_int_vector is unchanged when push_back throws") {
+    // The first block allocates the headers and then the words, so either allocation can fail
+    for (const int fail_after : {0, 1}) {
+        nstd::compressed_int_vector<failing_allocator<std::uint64_t>> compressed;
+        for (std::uint64_t i = 0; i + 1 < compressed.s_block_size; ++i) {
+            compressed.push_back(i * 3);
+        }
+
+        allocations_left = fail_after;
+        REQUIRE_THROWS_AS(compressed.push_back(1000), std::bad_alloc);
+        allocations_left = -1;
+        REQUIRE(compressed.size() == compressed.s_block_size - 1);
+
+        compressed.push_back(1000);
+        REQUIRE(compressed.size() == compressed.s_block_size);
+        for (std::uint64_t i = 0; i + 1 < compressed.s_block_size; ++i) {
+            REQUIRE(compressed[i] == i * 3);
+        }
+        REQUIRE(compressed[compressed.s_block_size - 1] == 1000U);
+    }
+}
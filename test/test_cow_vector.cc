@@ -0,0 +1,167 @@
+#include "cow_vector.hh"
+#include "vector.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Whether a reference to the underlying storage can be taken out of the handle
+template <typename Vector>
+concept exposes_writable_storage = requires(Vector &v) { v.write(); };
+
+} // namespace
+
+TEST_CASE("Test cow_vector constructors") {
+    SECTION("Test default constructor") {
+        nstd::cow_vector<int> vec;
+        REQUIRE(vec.empty());
+        REQUIRE(vec.size() == 0U);
+        // Reading from an empty cow_vector should not allocate any storage
+        REQUIRE(vec.use_count() == 0);
+    }
+
+    SECTION("Test initializer list constructor") {
+        nstd::cow_vector vec{1, 2, 3};
+        REQUIRE(vec.size() == 3U);
+        REQUIRE(vec[0] == 1);
+        REQUIRE(vec[1] == 2);
+        REQUIRE(vec[2] == 3);
+    }
+
+    SECTION("Test vector constructor") {
+        nstd::vector values{1, 2, 3};
+        nstd::cow_vector vec(std::move(values));
+        REQUIRE(vec.read() == nstd::vector{1, 2, 3});
+    }
+}
+
+TEST_CASE("Test cow_vector copies share storage") {
+    nstd::cow_vector vec{1, 2, 3};
+    // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+    nstd::cow_vector snapshot(vec);
+
+    REQUIRE(vec.data() == snapshot.data());
+    REQUIRE(vec.is_shared());
+    REQUIRE(snapshot.is_shared());
+    REQUIRE(vec.use_count() == 2);
+    REQUIRE(vec == snapshot);
+}
+
+TEST_CASE("Test cow_vector reads never detach") {
+    nstd::cow_vector vec{1, 2, 3};
+    // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+    const nstd::cow_vector snapshot(vec);
+    const auto *data = snapshot.data();
+
+    int i = 1;
+    for (const auto &element : snapshot) {
+        REQUIRE(element == i++);
+    }
+    REQUIRE(snapshot.front() == 1);
+    REQUIRE(snapshot.back() == 3);
+    REQUIRE(snapshot.at(1) == 2);
+    REQUIRE_THROWS_AS(snapshot.at(3), std::out_of_range);
+
+    REQUIRE(snapshot.data() == data);
+    REQUIRE(vec.data() == data);
+    REQUIRE(snapshot.use_count() == 2);
+}
+
+TEST_CASE("Test cow_vector writes detach lazily") {
+    SECTION("Test push_back") {
+        nstd::cow_vector vec{1, 2, 3};
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        nstd::cow_vector snapshot(vec);
+
+        vec.push_back(4);
+        REQUIRE(vec.size() == 4U);
+        REQUIRE(vec[3] == 4);
+        REQUIRE(snapshot.size() == 3U);
+        REQUIRE(vec.data() != snapshot.data());
+        REQUIRE(!vec.is_shared());
+        REQUIRE(!snapshot.is_shared());
+    }
+
+    SECTION("Test set") {
+        nstd::cow_vector vec{1, 2, 3};
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        nstd::cow_vector snapshot(vec);
+
+        vec.set(0, 42);
+        REQUIRE(vec[0] == 42);
+        REQUIRE(snapshot[0] == 1);
+        REQUIRE_THROWS_AS(vec.set(3, 0), std::out_of_range);
+    }
+
+    SECTION("Test modify on unshared storage does not copy") {
+        nstd::cow_vector vec{1, 2, 3};
+        const auto *data = vec.data();
+
+        vec.modify([](auto &v) { v[1] = 5; });
+        REQUIRE(vec.data() == data);
+        REQUIRE(vec[1] == 5);
+        REQUIRE(vec.modify([](const auto &v) { return v.size(); }) == 3U);
+    }
+
+    SECTION("Test modify on shared storage copies once") {
+        nstd::cow_vector vec{1, 2, 3};
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        nstd::cow_vector snapshot(vec);
+
+        const auto *data = vec.modify([](auto &v) {
+            v[0] = 10;
+            return v.data();
+        });
+        REQUIRE(data != snapshot.data());
+
+        // Later writes on the same handle should reuse the now unshared storage
+        vec.modify([](auto &v) { v[1] = 20; });
+        REQUIRE(vec.data() == data);
+        REQUIRE(snapshot[0] == 1);
+        REQUIRE(snapshot[1] == 2);
+    }
+
+    SECTION("Test snapshots taken between modifications are isolated") {
+        // No reference to the storage outlives modify, so nothing can write through to the snapshot after it is taken
+        STATIC_REQUIRE(!exposes_writable_storage<nstd::cow_vector<int>>);
+
+        nstd::cow_vector vec{1, 2, 3};
+        vec.modify([](auto &v) { v[0] = 10; });
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        nstd::cow_vector snapshot(vec);
+        vec.modify([](auto &v) { v[0] = 99; });
+
+        REQUIRE(vec[0] == 99);
+        REQUIRE(snapshot[0] == 10);
+    }
+
+    SECTION("Test pop_back") {
+        nstd::cow_vector vec{1, 2, 3};
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        nstd::cow_vector snapshot(vec);
+
+        vec.pop_back();
+        REQUIRE(vec.size() == 2U);
+        REQUIRE(snapshot.size() == 3U);
+    }
+
+    SECTION("Test clear") {
+        nstd::cow_vector vec{1, 2, 3};
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        nstd::cow_vector snapshot(vec);
+
+        vec.clear();
+        REQUIRE(vec.empty());
+        REQUIRE(snapshot.size() == 3U);
+        REQUIRE(snapshot.use_count() == 1);
+    }
+
+    SECTION("Test writing to a default constructed cow_vector") {
+        nstd::cow_vector<int> vec;
+        vec.emplace_back(1);
+        REQUIRE(vec.size() == 1U);
+        REQUIRE(vec.use_count() == 1);
+    }
+}
@@ -0,0 +1,113 @@
+#include "deferred_delete.hh"
+#include "shared_ptr.hh"
+#include "unique_ptr.hh"
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace {
+
+std::atomic<int> destructions = 0;
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions,hicpp-special-member-functions)
+struct destructor_counter {
+    int x;
+
+    ~destructor_counter() { ++destructions; }
+};
+
+} // namespace
+
+TEST_CASE("Test deferred_delete with unique_ptr") {
+    auto &reclaimer = nstd::deferred_reclaimer::instance();
+    reclaimer.drain();
+    destructions = 0;
+    const auto before = reclaimer.stats();
+
+    {
+        nstd::unique_ptr<destructor_counter, nstd::deferred_delete<destructor_counter>> ptr(new destructor_counter{1});
+        REQUIRE(ptr->x == 1);
+    }
+    // The object should be queued rather than destroyed when the unique_ptr goes out of scope
+    REQUIRE(destructions == 0);
+    REQUIRE(reclaimer.stats().deferred == before.deferred + 1);
+
+    REQUIRE(reclaimer.drain() == 1U);
+    REQUIRE(destructions == 1);
+    REQUIRE(reclaimer.stats().reclaimed == before.reclaimed + 1);
+    REQUIRE(reclaimer.stats().backlog == 0U);
+}
+
+TEST_CASE("Test deferred_delete with shared_ptr") {
+    auto &reclaimer = nstd::deferred_reclaimer::instance();
+    reclaimer.drain();
+    destructions = 0;
+
+    {
+        nstd::shared_ptr<destructor_counter> ptr(new destructor_counter{1},
+                                                 nstd::deferred_delete<destructor_counter>{});
+        {
+            // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+            auto copied(ptr);
+        }
+        REQUIRE(destructions == 0);
+    }
+    REQUIRE(destructions == 0);
+
+    reclaimer.drain();
+    REQUIRE(destructions == 1);
+}
+
+TEST_CASE("Test deferred_reclaimer batches and backlog") {
+    auto &reclaimer = nstd::deferred_reclaimer::instance();
+    reclaimer.drain();
+    destructions = 0;
+
+    SECTION("Test full batches are handed to the shared queue") {
+        for (std::size_t i = 0; i < nstd::deferred_reclaimer::s_batch_size; ++i) {
+            nstd::deferred_delete<destructor_counter>{}(new destructor_counter{0});
+        }
+        REQUIRE(reclaimer.stats().backlog == nstd::deferred_reclaimer::s_batch_size);
+
+        reclaimer.drain();
+        REQUIRE(destructions == static_cast<int>(nstd::deferred_reclaimer::s_batch_size));
+    }
+
+    SECTION("Test a full backlog destroys inline") {
+        const auto before = reclaimer.stats();
+        reclaimer.set_max_backlog(0);
+
+        nstd::deferred_delete<destructor_counter>{}(new destructor_counter{0});
+        reclaimer.flush();
+        REQUIRE(destructions == 1);
+        REQUIRE(reclaimer.stats().reclaimed_inline == before.reclaimed_inline + 1);
+        REQUIRE(reclaimer.stats().backlog == 0U);
+
+        reclaimer.set_max_backlog(nstd::deferred_reclaimer::s_default_max_backlog);
+    }
+}
+
+TEST_CASE("Test deferred_reclaimer background thread") {
+    auto &reclaimer = nstd::deferred_reclaimer::instance();
+    reclaimer.drain();
+    destructions = 0;
+
+    reclaimer.start(std::chrono::milliseconds{1});
+
+    // Objects deferred on a thread that exits are flushed to the shared queue when the thread exits
+    std::thread([] {
+        for (int i = 0; i < 10; ++i) {
+            nstd::deferred_delete<destructor_counter>{}(new destructor_counter{i});
+        }
+    }).join();
+
+    for (int i = 0; i < 1000 && destructions != 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    REQUIRE(destructions == 10);
+
+    reclaimer.stop();
+}
@@ -0,0 +1,181 @@
+#include "inplace_vector.hh"
+#include "vector.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+// Builds a table of squares at compile time
+constexpr nstd::inplace_vector<int, 8> make_squares() {
+    nstd::inplace_vector<int, 8> squares;
+    for (int i = 0; i < 8; ++i) {
+        squares.push_back(i * i);
+    }
+    return squares;
+}
+
+// Counts the live objects, and throws from a copy or move once `s_copies_left` reaches zero
+struct tracked {
+    static inline int s_live = 0;
+    static inline int s_copies_left = -1;
+
+    tracked() { ++s_live; }
+
+    tracked(const tracked & /*other*/) {
+        copy();
+        ++s_live;
+    }
+
+    // NOLINTNEXTLINE(performance-noexcept-move-constructor,hicpp-noexcept-move)
+    tracked(tracked && /*other*/) {
+        copy();
+        ++s_live;
+    }
+
+    tracked &operator=(const tracked &other) = default;
+    tracked &operator=(tracked &&other) = default;
+
+    ~tracked() { --s_live; }
+
+    static void copy() {
+        if (s_copies_left-- == 0) {
+            throw std::runtime_error("tracked");
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("Test inplace_vector stores elements inline") {
+    STATIC_REQUIRE(sizeof(nstd::inplace_vector<int, 4>) >= 4 * sizeof(int));
+    STATIC_REQUIRE(std::is_trivially_copyable_v<nstd::inplace_vector<int, 4>>);
+    STATIC_REQUIRE(!std::is_trivially_copyable_v<nstd::inplace_vector<nstd::vector<int>, 4>>);
+}
+
+TEST_CASE("Test inplace_vector in constant expressions") {
+    constexpr auto squares = make_squares();
+    STATIC_REQUIRE(squares.size() == 8);
+    STATIC_REQUIRE(squares[3] == 9);
+    STATIC_REQUIRE(squares.back() == 49);
+
+    constexpr nstd::inplace_vector<int, 4> literal{1, 2, 3};
+    STATIC_REQUIRE(literal.size() == 3);
+    STATIC_REQUIRE(literal == nstd::inplace_vector<int, 4>{1, 2, 3});
+}
+
+TEST_CASE("Test inplace_vector constructors") {
+    SECTION("Test default constructor") {
+        nstd::inplace_vector<int, 4> vec;
+        REQUIRE(vec.empty());
+        REQUIRE(vec.capacity() == 4U);
+    }
+
+    SECTION("Test initializer list constructor") {
+        nstd::inplace_vector<int, 4> vec{1, 2, 3};
+        REQUIRE(vec.size() == 3U);
+        REQUIRE(vec[0] == 1);
+        REQUIRE(vec[2] == 3);
+        REQUIRE_THROWS_AS((nstd::inplace_vector<int, 2>{1, 2, 3}), std::bad_alloc);
+    }
+
+    SECTION("Test copy and move with non trivial types") {
+        nstd::inplace_vector<nstd::vector<int>, 4> vec;
+        vec.emplace_back(nstd::vector{1, 2, 3});
+        vec.emplace_back(nstd::vector{4, 5});
+
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        auto copied(vec);
+        REQUIRE(copied == vec);
+
+        auto moved(std::move(vec));
+        REQUIRE(moved == copied);
+        // NOLINTNEXTLINE(bugprone-use-after-move,hicpp-invalid-access-moved)
+        REQUIRE(vec.empty());
+
+        vec = copied;
+        REQUIRE(vec == copied);
+    }
+}
+
+TEST_CASE("Test inplace_vector constructors clean up when an element throws") {
+    // The third copy or move throws, after two elements of the new vector were already built
+    nstd::inplace_vector<tracked, 4> vec;
+    vec.emplace_back();
+    vec.emplace_back();
+    vec.emplace_back();
+    REQUIRE(tracked::s_live == 3);
+
+    SECTION("Test copy constructor") {
+        tracked::s_copies_left = 2;
+        REQUIRE_THROWS_AS((nstd::inplace_vector<tracked, 4>(vec)), std::runtime_error);
+    }
+
+    SECTION("Test move constructor") {
+        tracked::s_copies_left = 2;
+        REQUIRE_THROWS_AS((nstd::inplace_vector<tracked, 4>(std::move(vec))), std::runtime_error);
+    }
+
+    SECTION("Test initializer list constructor") {
+        const tracked element;
+        tracked::s_copies_left = 2;
+        REQUIRE_THROWS_AS((nstd::inplace_vector<tracked, 4>{element, element, element}), std::runtime_error);
+        tracked::s_copies_left = -1;
+        REQUIRE(tracked::s_live == 4);
+    }
+
+    tracked::s_copies_left = -1;
+    REQUIRE(tracked::s_live == 3);
+}
+
+TEST_CASE("Test inplace_vector accessors") {
+    nstd::inplace_vector<int, 4> vec{1, 2, 3};
+
+    REQUIRE(vec.at(0) == 1);
+    REQUIRE_THROWS_AS(vec.at(3), std::out_of_range);
+    REQUIRE(vec.front() == 1);
+    REQUIRE(vec.back() == 3);
+
+    int i = 1;
+    for (const auto &element : vec) {
+        REQUIRE(element == i++);
+    }
+}
+
+TEST_CASE("Test inplace_vector overflow") {
+    nstd::inplace_vector<int, 2> vec;
+
+    SECTION("Test push_back throws when full") {
+        vec.push_back(1);
+        vec.push_back(2);
+        REQUIRE(vec.full());
+        REQUIRE_THROWS_AS(vec.push_back(3), std::bad_alloc);
+        REQUIRE(vec.size() == 2U);
+    }
+
+    SECTION("Test try_push_back returns nullptr when full") {
+        int *first = vec.try_push_back(1);
+        REQUIRE(first == &vec[0]);
+        REQUIRE(*first == 1);
+        REQUIRE(vec.try_emplace_back(2) != nullptr);
+        REQUIRE(vec.try_push_back(3) == nullptr);
+        REQUIRE(vec.size() == 2U);
+    }
+}
+
+TEST_CASE("Test inplace_vector pop_back and clear") {
+    nstd::inplace_vector<nstd::vector<int>, 4> vec;
+    vec.emplace_back(nstd::vector{1});
+    vec.emplace_back(nstd::vector{2});
+
+    vec.pop_back();
+    REQUIRE(vec.size() == 1U);
+    REQUIRE(vec.back() == nstd::vector{1});
+
+    vec.clear();
+    REQUIRE(vec.empty());
+}
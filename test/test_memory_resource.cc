@@ -0,0 +1,240 @@
+#include "memory_resource.hh"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Counts the calls to upstream so tests can check what reaches it
+class counting_resource : public nstd::pmr::memory_resource {
+  public:
+    std::size_t allocations{0};
+    std::size_t deallocations{0};
+    std::size_t bytes_outstanding{0};
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        bytes_outstanding += bytes;
+        return nstd::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        bytes_outstanding -= bytes;
+        nstd::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override { return this == &other; }
+};
+
+bool is_aligned(const void *ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+} // namespace
+
+TEST_CASE("Test pmr default resource") {
+    REQUIRE(nstd::pmr::get_default_resource() == nstd::pmr::new_delete_resource());
+
+    counting_resource counter;
+    auto *previous = nstd::pmr::set_default_resource(&counter);
+    REQUIRE(nstd::pmr::get_default_resource() == &counter);
+    nstd::pmr::set_default_resource(previous);
+    REQUIRE(nstd::pmr::get_default_resource() == nstd::pmr::new_delete_resource());
+}
+
+TEST_CASE("Test monotonic_buffer_resource") {
+    counting_resource upstream;
+
+    SECTION("Test allocations come from the initial buffer") {
+        alignas(std::max_align_t) std::array<std::byte, 256> buffer{};
+        nstd::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), &upstream);
+
+        auto *a = static_cast<std::byte *>(resource.allocate(10, 1));
+        auto *b = static_cast<std::byte *>(resource.allocate(16, 8));
+        REQUIRE(a == buffer.data());
+        REQUIRE(b >= a + 10);
+        REQUIRE(is_aligned(b, 8));
+        REQUIRE(upstream.allocations == 0U);
+
+        // Does not fit in the remaining buffer
+        static_cast<void>(resource.allocate(1000));
+        REQUIRE(upstream.allocations == 1U);
+    }
+
+    SECTION("Test release gives memory back to upstream") {
+        nstd::pmr::monotonic_buffer_resource resource(&upstream);
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(is_aligned(resource.allocate(100, 64), 64));
+        }
+        REQUIRE(upstream.allocations > 0U);
+
+        resource.release();
+        REQUIRE(upstream.deallocations == upstream.allocations);
+        REQUIRE(upstream.bytes_outstanding == 0U);
+    }
+}
+
+TEST_CASE("Test unsynchronized_pool_resource") {
+    counting_resource upstream;
+
+    SECTION("Test freed blocks are reused") {
+        nstd::pmr::unsynchronized_pool_resource resource(&upstream);
+
+        void *a = resource.allocate(24);
+        resource.deallocate(a, 24);
+        const auto allocations = upstream.allocations;
+
+        void *b = resource.allocate(24);
+        REQUIRE(b == a);
+        REQUIRE(upstream.allocations == allocations);
+        resource.deallocate(b, 24);
+    }
+
+    SECTION("Test alignment") {
+        nstd::pmr::unsynchronized_pool_resource resource(&upstream);
+        for (std::size_t alignment = 1; alignment <= 4096; alignment *= 2) {
+            void *ptr = resource.allocate(alignment, alignment);
+            REQUIRE(is_aligned(ptr, alignment));
+            resource.deallocate(ptr, alignment, alignment);
+        }
+    }
+
+    SECTION("Test oversized allocations go to upstream") {
+        nstd::pmr::unsynchronized_pool_resource resource({.max_blocks_per_chunk = 0, .largest_required_pool_block = 64},
+                                                         &upstream);
+        REQUIRE(resource.options().largest_required_pool_block == 64U);
+
+        void *ptr = resource.allocate(1000);
+        REQUIRE(upstream.bytes_outstanding >= 1000U);
+        resource.deallocate(ptr, 1000);
+        REQUIRE(upstream.bytes_outstanding == 0U);
+    }
+
+    SECTION("Test many oversized allocations freed in any order") {
+        nstd::pmr::unsynchronized_pool_resource resource({.max_blocks_per_chunk = 0, .largest_required_pool_block = 64},
+                                                         &upstream);
+        std::vector<std::pair<std::byte *, std::size_t>> allocations;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const std::size_t alignment = std::size_t{1} << (i % 13);
+            auto *ptr = static_cast<std::byte *>(resource.allocate(100 + i, alignment));
+            REQUIRE(is_aligned(ptr, alignment));
+            std::fill(ptr, ptr + 100 + i, std::byte{0xff});
+            allocations.emplace_back(ptr, alignment);
+        }
+
+        // Free from the middle, then the ends, so every position in the list is unlinked at some point
+        for (std::size_t i = 0; i < allocations.size(); i += 3) {
+            resource.deallocate(allocations[i].first, 100 + i, allocations[i].second);
+        }
+        resource.deallocate(allocations[1].first, 101, allocations[1].second);
+        resource.deallocate(allocations[998].first, 1098, allocations[998].second);
+        REQUIRE(upstream.deallocations == 336U);
+
+        // The rest are freed by release
+        resource.release();
+        REQUIRE(upstream.bytes_outstanding == 0U);
+    }
+
+    SECTION("Test destructor releases everything") {
+        {
+            nstd::pmr::unsynchronized_pool_resource resource(&upstream);
+            for (std::size_t i = 1; i < 10000; i += 7) {
+                static_cast<void>(resource.allocate(i));
+            }
+        }
+        REQUIRE(upstream.bytes_outstanding == 0U);
+    }
+}
+
+TEST_CASE("Test synchronized_pool_resource") {
+    nstd::pmr::synchronized_pool_resource resource;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&resource, t] {
+            std::vector<void *> allocations;
+            const std::size_t size = 8 << t;
+            for (int i = 0; i < 1000; ++i) {
+                allocations.push_back(resource.allocate(size));
+                // Mixing in a shared size class makes threads contend on the same pool
+                resource.deallocate(resource.allocate(32), 32);
+            }
+            for (void *ptr : allocations) {
+                resource.deallocate(ptr, size);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+TEST_CASE("Test polymorphic_allocator") {
+    counting_resource upstream;
+
+    SECTION("Test pmr::vector has the same type for every resource") {
+        nstd::pmr::monotonic_buffer_resource arena(&upstream);
+        nstd::pmr::vector<int> from_arena(&arena);
+        nstd::pmr::vector<int> from_heap;
+        STATIC_REQUIRE(std::is_same_v<decltype(from_arena), decltype(from_heap)>);
+
+        for (int i = 0; i < 100; ++i) {
+            from_arena.push_back(i);
+            from_heap.push_back(i);
+        }
+        REQUIRE(from_arena == from_heap);
+        REQUIRE(from_arena.get_allocator().resource() == &arena);
+        REQUIRE(from_heap.get_allocator().resource() == nstd::pmr::get_default_resource());
+        REQUIRE(upstream.allocations > 0U);
+    }
+
+    SECTION("Test copies use the default resource") {
+        nstd::pmr::vector<int> vec(&upstream);
+        vec.push_back(1);
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        nstd::pmr::vector<int> copy(vec);
+        REQUIRE(copy.get_allocator().resource() == nstd::pmr::get_default_resource());
+    }
+
+    SECTION("Test equality") {
+        nstd::pmr::polymorphic_allocator<int> a(&upstream);
+        nstd::pmr::polymorphic_allocator<double> b(&upstream);
+        nstd::pmr::polymorphic_allocator<int> c;
+        REQUIRE(a == b);
+        REQUIRE(!(a == c));
+    }
+}
+
+TEST_CASE("Test pmr smart pointers") {
+    counting_resource upstream;
+
+    SECTION("Test make_unique") {
+        {
+            auto ptr = nstd::pmr::make_unique<int>(&upstream, 2);
+            REQUIRE(*ptr == 2);
+            REQUIRE(upstream.allocations == 1U);
+            REQUIRE(ptr.get_deleter().resource() == &upstream);
+        }
+        REQUIRE(upstream.deallocations == 1U);
+    }
+
+    SECTION("Test make_shared") {
+        {
+            auto ptr = nstd::pmr::make_shared<int>(&upstream, 2);
+            // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+            auto copied(ptr);
+            REQUIRE(*copied == 2);
+            REQUIRE(upstream.allocations == 1U);
+        }
+        REQUIRE(upstream.deallocations == 1U);
+    }
+}
@@ -0,0 +1,90 @@
+#include "inplace_vector.hh"
+#include "vector.hh"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+using iterator = nstd::vector<int>::iterator;
+using const_iterator = nstd::vector<int>::const_iterator;
+
+TEST_CASE("Test normal_iterator models contiguous_iterator") {
+    STATIC_REQUIRE(std::contiguous_iterator<iterator>);
+    STATIC_REQUIRE(std::contiguous_iterator<const_iterator>);
+    STATIC_REQUIRE(std::contiguous_iterator<nstd::inplace_vector<int, 4>::iterator>);
+    STATIC_REQUIRE(std::ranges::contiguous_range<nstd::vector<int>>);
+    STATIC_REQUIRE(std::ranges::contiguous_range<const nstd::vector<int>>);
+    STATIC_REQUIRE(std::sized_sentinel_for<const_iterator, iterator>);
+}
+
+TEST_CASE("Test normal_iterator conversions") {
+    STATIC_REQUIRE(std::is_convertible_v<iterator, const_iterator>);
+    STATIC_REQUIRE(!std::is_convertible_v<const_iterator, iterator>);
+    // Iterators from different container types should not mix
+    STATIC_REQUIRE(!std::is_convertible_v<iterator, nstd::inplace_vector<int, 4>::iterator>);
+
+    nstd::vector vec{1, 2, 3};
+    const_iterator it = vec.begin();
+    REQUIRE(it == vec.cbegin());
+    REQUIRE(vec.end() - it == 3);
+    REQUIRE(it < vec.end());
+}
+
+TEST_CASE("Test normal_iterator arithmetic") {
+    nstd::vector vec{1, 2, 3};
+
+    SECTION("Test postfix operators return the old position") {
+        auto it = vec.begin();
+        auto old = it++;
+        REQUIRE(*old == 1);
+        REQUIRE(*it == 2);
+
+        old = it--;
+        REQUIRE(*old == 2);
+        REQUIRE(*it == 1);
+    }
+
+    SECTION("Test n + it") {
+        REQUIRE(*(2 + vec.begin()) == 3);
+        REQUIRE(2 + vec.begin() == vec.begin() + 2);
+    }
+
+    SECTION("Test ordering") {
+        auto first = vec.begin();
+        auto last = vec.end() - 1;
+        REQUIRE(first < last);
+        REQUIRE(first <= first);
+        REQUIRE(last > first);
+        REQUIRE(last >= last);
+        REQUIRE((first <=> last) == std::strong_ordering::less);
+    }
+
+    SECTION("Test std::to_address") {
+        REQUIRE(std::to_address(vec.begin()) == vec.data());
+        REQUIRE(std::to_address(vec.cend()) == vec.data() + vec.size());
+    }
+}
+
+TEST_CASE("Test normal_iterator with STL algorithms") {
+    nstd::vector vec{3, 1, 2};
+
+    SECTION("Test std::sort") {
+        std::sort(vec.begin(), vec.end());
+        REQUIRE(vec == nstd::vector{1, 2, 3});
+    }
+
+    SECTION("Test std::ranges::copy") {
+        nstd::vector<int> copy;
+        copy.reserve(vec.size());
+        std::ranges::copy(vec, std::back_inserter(copy));
+        REQUIRE(copy == vec);
+    }
+
+    SECTION("Test std::ranges::reverse") {
+        std::ranges::reverse(vec);
+        REQUIRE(vec == nstd::vector{2, 1, 3});
+    }
+}
@@ -0,0 +1,101 @@
+#include "object_pool.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct message {
+    int id;
+    double payload;
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions,hicpp-special-member-functions)
+struct destructor_counter {
+    int *destructions;
+
+    ~destructor_counter() { ++*destructions; }
+};
+
+} // namespace
+
+TEST_CASE("Test object_pool pointer size is same as STL") {
+    STATIC_REQUIRE(sizeof(std::unique_ptr<message>) == sizeof(nstd::object_pool<message>::pointer));
+}
+
+TEST_CASE("Test object_pool::acquire") {
+    nstd::object_pool<message> pool;
+
+    auto msg = pool.acquire(1, 2.0);
+    REQUIRE(msg->id == 1);
+    REQUIRE(msg->payload == 2.0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(msg.get()) % alignof(message) == 0);
+}
+
+TEST_CASE("Test object_pool recycles memory") {
+    nstd::object_pool<message> pool;
+
+    SECTION("Test released memory is reused") {
+        auto *address = pool.acquire(1, 0.0).get();
+        // The previous object was released at the end of the statement above, so its slot should be handed out again
+        auto msg = pool.acquire(2, 0.0);
+        REQUIRE(msg.get() == address);
+        REQUIRE(msg->id == 2);
+    }
+
+    SECTION("Test steady state allocates no new slabs") {
+        std::vector<nstd::object_pool<message>::pointer> live;
+        for (int i = 0; i < 1000; ++i) {
+            live.push_back(pool.acquire(i, 0.0));
+        }
+        live.clear();
+
+        const auto slabs = pool.slab_count();
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 1000; ++i) {
+                live.push_back(pool.acquire(i, 0.0));
+            }
+            live.clear();
+        }
+        REQUIRE(pool.slab_count() == slabs);
+    }
+
+    SECTION("Test objects are destroyed when released") {
+        nstd::object_pool<destructor_counter> counter_pool;
+        int destructions = 0;
+        {
+            auto counter = counter_pool.acquire(&destructions);
+            REQUIRE(destructions == 0);
+        }
+        REQUIRE(destructions == 1);
+    }
+}
+
+TEST_CASE("Test object_pool across threads") {
+    nstd::object_pool<message> pool;
+    constexpr std::size_t n = 10000;
+
+    // Objects acquired on one thread and released on another should end up back in circulation
+    std::vector<nstd::object_pool<message>::pointer> live;
+    live.reserve(n);
+    std::thread([&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            live.push_back(pool.acquire(static_cast<int>(i), 0.0));
+        }
+    }).join();
+
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(live[i]->id == static_cast<int>(i));
+    }
+    live.clear();
+
+    const auto slabs = pool.slab_count();
+    for (std::size_t i = 0; i < n; ++i) {
+        live.push_back(pool.acquire(0, 0.0));
+    }
+    REQUIRE(pool.slab_count() == slabs);
+}
@@ -0,0 +1,183 @@
+#include "persistent_vector.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Throws from its constructor once `s_constructions_left` reaches zero
+struct throws_on_construction {
+    static inline int s_constructions_left = -1;
+
+    int value;
+
+    explicit throws_on_construction(int x) : value(x) {
+        if (s_constructions_left-- == 0) {
+            throw std::runtime_error("throws_on_construction");
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("Test persistent_vector constructors") {
+    SECTION("Test default constructor") {
+        nstd::persistent_vector<int> vec;
+        REQUIRE(vec.empty());
+        REQUIRE(vec.size() == 0U);
+        REQUIRE(vec.begin() == vec.end());
+    }
+
+    SECTION("Test initializer list constructor") {
+        nstd::persistent_vector vec{1, 2, 3};
+        REQUIRE(vec.size() == 3U);
+        REQUIRE(vec[0] == 1);
+        REQUIRE(vec[1] == 2);
+        REQUIRE(vec[2] == 3);
+    }
+}
+
+TEST_CASE("Test persistent_vector accessors") {
+    nstd::persistent_vector vec{1, 2, 3};
+
+    REQUIRE(vec.at(0) == 1);
+    REQUIRE(vec.at(2) == 3);
+    REQUIRE_THROWS_AS(vec.at(3), std::out_of_range);
+    REQUIRE(vec.front() == 1);
+    REQUIRE(vec.back() == 3);
+}
+
+TEST_CASE("Test persistent_vector modifications keep old versions intact") {
+    SECTION("Test push_back") {
+        nstd::persistent_vector<int> empty;
+        auto one = empty.push_back(1);
+        auto two = one.push_back(2);
+
+        REQUIRE(empty.empty());
+        REQUIRE(one == nstd::persistent_vector{1});
+        REQUIRE(two == nstd::persistent_vector{1, 2});
+    }
+
+    SECTION("Test set") {
+        nstd::persistent_vector vec{1, 2, 3};
+        auto changed = vec.set(1, 42);
+
+        REQUIRE(vec == nstd::persistent_vector{1, 2, 3});
+        REQUIRE(changed == nstd::persistent_vector{1, 42, 3});
+        REQUIRE_THROWS_AS(vec.set(3, 0), std::out_of_range);
+    }
+
+    SECTION("Test pop_back") {
+        nstd::persistent_vector vec{1, 2, 3};
+        auto popped = vec.pop_back();
+
+        REQUIRE(vec.size() == 3U);
+        REQUIRE(popped == nstd::persistent_vector{1, 2});
+    }
+}
+
+TEST_CASE("Test persistent_vector with many elements") {
+    // Enough elements for the trie to grow a couple of levels deep
+    constexpr std::size_t n = 40000;
+
+    nstd::persistent_vector<std::size_t> vec;
+    std::vector<nstd::persistent_vector<std::size_t>> versions;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 1000 == 0) {
+            versions.push_back(vec);
+        }
+        vec = vec.push_back(i);
+    }
+
+    REQUIRE(vec.size() == n);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(vec[i] == i);
+    }
+
+    // Every old version should still see exactly what it had when it was taken
+    for (std::size_t v = 0; v < versions.size(); ++v) {
+        REQUIRE(versions[v].size() == v * 1000);
+        REQUIRE((versions[v].empty() || versions[v].back() == (v * 1000) - 1));
+    }
+
+    SECTION("Test set deep in the trie") {
+        auto changed = vec.set(12345, 0);
+        REQUIRE(changed[12345] == 0);
+        REQUIRE(vec[12345] == 12345);
+        REQUIRE(changed[12346] == 12346);
+    }
+
+    SECTION("Test iterating") {
+        std::size_t i = 0;
+        for (const auto &element : vec) {
+            REQUIRE(element == i++);
+        }
+        REQUIRE(i == n);
+    }
+
+    SECTION("Test popping everything") {
+        auto popped = vec;
+        for (std::size_t i = n; i > 0; --i) {
+            REQUIRE(popped.back() == i - 1);
+            popped = popped.pop_back();
+        }
+        REQUIRE(popped.empty());
+        REQUIRE(vec.size() == n);
+    }
+}
+
+TEST_CASE("Test transient_vector") {
+    nstd::persistent_vector vec{1, 2, 3};
+
+    SECTION("Test batched updates") {
+        auto transient = vec.transient();
+        for (int i = 4; i <= 100; ++i) {
+            transient.push_back(i);
+        }
+        transient.set(0, 42);
+        transient.pop_back();
+
+        auto result = std::move(transient).persistent();
+        REQUIRE(result.size() == 99U);
+        REQUIRE(result[0] == 42);
+        REQUIRE(result.back() == 99);
+
+        // The vector the transient was created from should be untouched
+        REQUIRE(vec == nstd::persistent_vector{1, 2, 3});
+    }
+
+    SECTION("Test persistent leaves the transient empty") {
+        auto transient = vec.transient();
+        auto result = std::move(transient).persistent();
+        REQUIRE(result == vec);
+        // NOLINTNEXTLINE(bugprone-use-after-move,hicpp-invalid-access-moved)
+        REQUIRE(transient.empty());
+    }
+}
+
+TEST_CASE("Test transient_vector is unchanged when emplace_back throws") {
+    // Sizes where the tail is full, so the push has to move the tail into the trie and, at 1056, grow the trie
+    for (const std::size_t n : {1U, 32U, 64U, 1056U}) {
+        nstd::transient_vector<throws_on_construction> transient;
+        for (std::size_t i = 0; i < n; ++i) {
+            transient.emplace_back(static_cast<int>(i));
+        }
+
+        throws_on_construction::s_constructions_left = 0;
+        REQUIRE_THROWS_AS(transient.emplace_back(-1), std::runtime_error);
+        throws_on_construction::s_constructions_left = -1;
+
+        REQUIRE(transient.size() == n);
+        for (std::size_t i = 0; i < n; ++i) {
+            REQUIRE(transient[i].value == static_cast<int>(i));
+        }
+
+        transient.emplace_back(static_cast<int>(n));
+        REQUIRE(transient.size() == n + 1);
+        REQUIRE(transient[n].value == static_cast<int>(n));
+        REQUIRE(transient[0].value == 0);
+    }
+}
@@ -1,7 +1,10 @@
 #include "shared_ptr.hh"
 
 #include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 
 struct complex_type {
     int x;
@@ -50,17 +53,144 @@ TEST_CASE("Test shared_ptr rule of 5") {
         REQUIRE(copied.use_count() == 2);
     }
 
-    // SECTION("Test move constructor") {
-    //     auto heap_int = nstd::make_shared<int>(2);
-    //     nstd::shared_ptr<int> moved(std::move(heap_int));
-    //     REQUIRE(heap_int.get() == nullptr);
-    //     REQUIRE(*moved == 2);
-    // }
-    //
-    // SECTION("Test move assignment operator") {
-    //     auto heap_int = nstd::make_shared<int>(2);
-    //     nstd::shared_ptr<int> moved = std::move(heap_int);
-    //     REQUIRE(heap_int.get() == nullptr);
-    //     REQUIRE(*moved == 2);
-    // }
+    SECTION("Test move constructor") {
+        auto heap_int = nstd::make_shared<int>(2);
+        nstd::shared_ptr<int> moved(std::move(heap_int));
+        REQUIRE(heap_int.get() == nullptr);
+        REQUIRE(*moved == 2);
+        REQUIRE(moved.use_count() == 1);
+    }
+
+    SECTION("Test copy assignment operator") {
+        auto heap_int = nstd::make_shared<int>(2);
+        auto other = nstd::make_shared<int>(3);
+        other = heap_int;
+        REQUIRE(*other == 2);
+        REQUIRE(heap_int.use_count() == 2);
+        REQUIRE(other.use_count() == 2);
+    }
+
+    SECTION("Test move assignment operator") {
+        auto heap_int = nstd::make_shared<int>(2);
+        nstd::shared_ptr<int> moved = std::move(heap_int);
+        REQUIRE(heap_int.get() == nullptr);
+        REQUIRE(*moved == 2);
+    }
+}
+
+TEST_CASE("Test shared_ptr destroys managed object") {
+    // NOLINTNEXTLINE(cppcoreguidelines-special-member-functions,hicpp-special-member-functions)
+    struct destructor_counter {
+        int *destructions;
+
+        ~destructor_counter() { ++*destructions; }
+    };
+
+    int destructions = 0;
+    {
+        auto heap_counter = nstd::make_shared<destructor_counter>(&destructions);
+        {
+            // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+            auto copied(heap_counter);
+        }
+        REQUIRE(destructions == 0);
+
+        heap_counter.reset();
+        REQUIRE(destructions == 1);
+        REQUIRE(heap_counter.use_count() == 0);
+    }
+    REQUIRE(destructions == 1);
+}
+
+TEST_CASE("Test shared_ptr calls the deleter when the control block cannot be made") {
+    // Moving the deleter into the control block throws, which should be handled like a failed allocation
+    struct throwing_deleter {
+        int *deletions;
+
+        explicit throwing_deleter(int *deletions) : deletions(deletions) {}
+        throwing_deleter(const throwing_deleter &other) = default;
+        // NOLINTNEXTLINE(performance-noexcept-move-constructor,hicpp-noexcept-move)
+        throwing_deleter(throwing_deleter && /*other*/) { throw std::bad_alloc(); }
+        throwing_deleter &operator=(const throwing_deleter &other) = delete;
+        throwing_deleter &operator=(throwing_deleter &&other) = delete;
+        ~throwing_deleter() = default;
+
+        void operator()(const int *ptr) const {
+            ++*deletions;
+            delete ptr;
+        }
+    };
+
+    int deletions = 0;
+    REQUIRE_THROWS_AS(nstd::shared_ptr<int>(new int{1}, throwing_deleter{&deletions}), std::bad_alloc);
+    REQUIRE(deletions == 1);
+}
+
+TEST_CASE("Test shared_ptr with a deleter that throws on a later move") {
+    // Throws from the move that makes `moves_left` reach zero, so every move the constructor makes can be made to throw
+    struct counting_deleter {
+        int *deletions;
+        int *moves_left;
+
+        counting_deleter(int *deletions, int *moves_left) : deletions(deletions), moves_left(moves_left) {}
+        counting_deleter(const counting_deleter &other) = default;
+        // NOLINTNEXTLINE(performance-noexcept-move-constructor,hicpp-noexcept-move)
+        counting_deleter(counting_deleter &&other) : deletions(other.deletions), moves_left(other.moves_left) {
+            if (--*moves_left == 0) {
+                throw std::bad_alloc();
+            }
+        }
+        counting_deleter &operator=(const counting_deleter &other) = delete;
+        counting_deleter &operator=(counting_deleter &&other) = delete;
+        ~counting_deleter() = default;
+
+        void operator()(const int *ptr) const {
+            ++*deletions;
+            delete ptr;
+        }
+    };
+
+    for (int throw_on_move = 1; throw_on_move <= 3; ++throw_on_move) {
+        int deletions = 0;
+        int moves_left = throw_on_move;
+        try {
+            const nstd::shared_ptr<int> ptr(new int{1}, counting_deleter(&deletions, &moves_left));
+            REQUIRE(deletions == 0);
+        } catch (const std::bad_alloc &) {
+            REQUIRE(deletions == 1);
+        }
+        REQUIRE(deletions == 1);
+    }
+}
+
+TEST_CASE("Test shared_ptr for arrays") {
+    SECTION("Test make_shared value initializes") {
+        auto heap_array = nstd::make_shared<int[]>(4);
+        for (std::size_t i = 0; i < 4; ++i) {
+            REQUIRE(heap_array[i] == 0);
+        }
+    }
+
+    SECTION("Test copies share the array") {
+        auto heap_array = nstd::make_shared_for_overwrite<int[]>(4);
+        heap_array[0] = 1;
+        // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+        auto copied(heap_array);
+        REQUIRE(copied[0] == 1);
+        REQUIRE(copied.use_count() == 2);
+    }
+
+    SECTION("Test aligned array") {
+        constexpr std::size_t alignment = 64;
+        auto buffer = nstd::make_shared_for_overwrite<double[]>(10, std::align_val_t{alignment});
+        REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.get()) % alignment == 0);
+        buffer[9] = 1.0;
+        REQUIRE(buffer[9] == 1.0);
+    }
+}
+
+TEST_CASE("Test make_shared_for_overwrite") {
+    auto heap_int = nstd::make_shared_for_overwrite<int>();
+    *heap_int = 2;
+    REQUIRE(*heap_int == 2);
 }
@@ -0,0 +1,138 @@
+#include "slot_map.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("Test slot_map insert and lookup") {
+    nstd::slot_map<std::string> map;
+    REQUIRE(map.empty());
+    REQUIRE(!map.contains(nstd::slot_map_handle{}));
+
+    const auto a = map.insert("a");
+    const auto b = map.emplace(3, 'b');
+    REQUIRE(map.size() == 2U);
+    REQUIRE(a != b);
+    REQUIRE(map.contains(a));
+    REQUIRE(map[a] == "a");
+    REQUIRE(*map.get(b) == "bbb");
+    REQUIRE(map.at(b) == "bbb");
+
+    map[a] += "!";
+    REQUIRE(map.at(a) == "a!");
+
+    // A handle to a slot that has never been filled
+    REQUIRE(!map.contains({.index = 5, .generation = 1}));
+    REQUIRE(map.get({.index = 5, .generation = 1}) == nullptr);
+    REQUIRE_THROWS_AS(map.at({.index = 5, .generation = 1}), std::out_of_range);
+}
+
+TEST_CASE("Test slot_map erase") {
+    nstd::slot_map<int> map;
+    const auto a = map.insert(1);
+    const auto b = map.insert(2);
+    const auto c = map.insert(3);
+
+    SECTION("Test erased handles become stale") {
+        REQUIRE(map.erase(a));
+        REQUIRE(!map.erase(a));
+        REQUIRE(!map.contains(a));
+        REQUIRE(map.get(a) == nullptr);
+        REQUIRE_THROWS_AS(map.at(a), std::out_of_range);
+
+        // The last element was moved into the erased element's place
+        REQUIRE(map.size() == 2U);
+        REQUIRE(map[b] == 2);
+        REQUIRE(map[c] == 3);
+        REQUIRE(*map.begin() == 3);
+
+        // The slot is reused, but the old handle still does not match it
+        const auto d = map.insert(4);
+        REQUIRE(d.index == a.index);
+        REQUIRE(!map.contains(a));
+        REQUIRE(map[d] == 4);
+    }
+
+    SECTION("Test erasing the last element") {
+        REQUIRE(map.erase(c));
+        REQUIRE(map.size() == 2U);
+        REQUIRE(map[a] == 1);
+        REQUIRE(map[b] == 2);
+    }
+
+    SECTION("Test clear") {
+        map.clear();
+        REQUIRE(map.empty());
+        REQUIRE(!map.contains(a));
+        REQUIRE(!map.contains(b));
+        REQUIRE(!map.contains(c));
+
+        const auto d = map.insert(4);
+        REQUIRE(map.size() == 1U);
+        REQUIRE(map[d] == 4);
+    }
+}
+
+TEST_CASE("Test slot_map iteration") {
+    nstd::slot_map<int> map;
+    for (int i = 0; i < 10; ++i) {
+        static_cast<void>(map.insert(i));
+    }
+
+    STATIC_REQUIRE(std::contiguous_iterator<nstd::slot_map<int>::iterator>);
+    REQUIRE(std::distance(map.begin(), map.end()) == 10);
+    REQUIRE(map.data() == &*map.begin());
+
+    for (auto &x : map) {
+        x *= 2;
+    }
+    for (std::size_t i = 0; i < map.size(); ++i) {
+        REQUIRE(map[map.handle_at(i)] == map.data()[i]);
+    }
+}
+
+TEST_CASE("Test slot_map against a reference") {
+    // Random inserts and erases, checked against a map from handles to values
+    nstd::slot_map<int> map;
+    std::unordered_map<nstd::slot_map_handle, int> expected;
+    std::vector<nstd::slot_map_handle> erased;
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp)
+    std::mt19937 engine(1);
+
+    for (int i = 0; i < 10000; ++i) {
+        if (expected.empty() || engine() % 3 != 0) {
+            const auto h = map.insert(i);
+            REQUIRE(!expected.contains(h));
+            expected.emplace(h, i);
+        } else {
+            auto it = expected.begin();
+            std::advance(it, static_cast<std::ptrdiff_t>(engine() % expected.size()));
+            REQUIRE(map.erase(it->first));
+            erased.push_back(it->first);
+            expected.erase(it);
+        }
+    }
+
+    REQUIRE(map.size() == expected.size());
+    for (const auto &[h, x] : expected) {
+        REQUIRE(map.contains(h));
+        REQUIRE(map[h] == x);
+    }
+    for (const auto h : erased) {
+        REQUIRE(!map.contains(h));
+    }
+
+    // Every element is reachable through the handle of its position
+    std::unordered_set<int> seen(map.begin(), map.end());
+    REQUIRE(seen.size() == map.size());
+    for (std::size_t i = 0; i < map.size(); ++i) {
+        REQUIRE(expected.at(map.handle_at(i)) == map.data()[i]);
+    }
+}
@@ -0,0 +1,212 @@
+#include "sort.hh"
+#include "vector.hh"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Fills an nstd::vector with `n` random values from `distribution`, and returns it along with a copy sorted by
+// std::sort to compare against
+template <typename T, typename Distribution> auto random_vectors(std::size_t n, Distribution distribution) {
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp)
+    std::mt19937_64 engine(n);
+    nstd::vector<T> vec;
+    std::vector<T> expected;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto x = static_cast<T>(distribution(engine));
+        vec.push_back(x);
+        expected.push_back(x);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    return std::pair{std::move(vec), std::move(expected)};
+}
+
+template <typename T, typename Expected> bool equal(const nstd::vector<T> &vec, const Expected &expected) {
+    return std::equal(vec.begin(), vec.end(), expected.begin(), expected.end());
+}
+
+template <typename T, typename Distribution> void check_sort(Distribution distribution) {
+    for (const std::size_t n : {0U, 1U, 100U, 1000U, 100000U}) {
+        auto [vec, expected] = random_vectors<T>(n, distribution);
+        nstd::sort(vec);
+        REQUIRE(equal(vec, expected));
+    }
+}
+
+struct entry {
+    std::uint32_t key;
+    std::uint32_t order;
+};
+
+// Only 16 distinct keys, so there are plenty of equal keys to check stability with
+template <typename Allocator = std::allocator<entry>> nstd::vector<entry, Allocator> random_entries(std::size_t n) {
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp)
+    std::mt19937 engine(n);
+    std::uniform_int_distribution<std::uint32_t> distribution(0, 15);
+    nstd::vector<entry, Allocator> vec;
+    for (std::uint32_t i = 0; i < n; ++i) {
+        vec.push_back({.key = distribution(engine), .order = i});
+    }
+    return vec;
+}
+
+// Counts its allocations. The radix sorts allocate their scratch buffer through the vector's allocator, which tells
+// whether they were used rather than a comparison sort
+template <typename T> struct counting_allocator {
+    using value_type = T;
+
+    static inline std::size_t allocations = 0;
+
+    counting_allocator() = default;
+
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    template <typename U> constexpr counting_allocator(const counting_allocator<U> & /*other*/) noexcept {}
+
+    T *allocate(std::size_t n) {
+        ++allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept { std::allocator<T>{}.deallocate(ptr, n); }
+
+    [[nodiscard]] bool operator==(const counting_allocator & /*other*/) const noexcept = default;
+};
+
+} // namespace
+
+TEST_CASE("Test sort") {
+    SECTION("Test unsigned integers") { check_sort<std::uint64_t>(std::uniform_int_distribution<std::uint64_t>{}); }
+
+    SECTION("Test signed integers") {
+        check_sort<std::int32_t>(std::uniform_int_distribution<std::int32_t>{std::numeric_limits<std::int32_t>::min(),
+                                                                             std::numeric_limits<std::int32_t>::max()});
+    }
+
+    SECTION("Test small range") {
+        // Most passes are skipped since the upper bytes are the same for every key
+        check_sort<std::int64_t>(std::uniform_int_distribution<std::int64_t>{-100, 100});
+    }
+
+    SECTION("Test bytes") { check_sort<std::int8_t>(std::uniform_int_distribution<int>{-128, 127}); }
+
+    SECTION("Test floats") { check_sort<float>(std::normal_distribution<float>{0.0F, 1000.0F}); }
+
+    SECTION("Test doubles") { check_sort<double>(std::uniform_real_distribution<double>{-1e300, 1e300}); }
+}
+
+TEST_CASE("Test sort edge cases") {
+    SECTION("Test infinities and extremes") {
+        nstd::vector<double> vec;
+        for (int i = 0; i < 100; ++i) {
+            vec.push_back(std::numeric_limits<double>::infinity());
+            vec.push_back(-std::numeric_limits<double>::infinity());
+            vec.push_back(std::numeric_limits<double>::max());
+            vec.push_back(std::numeric_limits<double>::lowest());
+            vec.push_back(std::numeric_limits<double>::denorm_min());
+            vec.push_back(static_cast<double>(i) - 50);
+        }
+        nstd::sort(vec);
+        REQUIRE(std::is_sorted(vec.begin(), vec.end()));
+        REQUIRE(vec.front() == -std::numeric_limits<double>::infinity());
+        REQUIRE(vec.back() == std::numeric_limits<double>::infinity());
+    }
+
+    SECTION("Test already sorted and reversed") {
+        nstd::vector<std::uint32_t> ascending;
+        nstd::vector<std::uint32_t> descending;
+        for (std::uint32_t i = 0; i < 1000; ++i) {
+            ascending.push_back(i);
+            descending.push_back(999 - i);
+        }
+        nstd::sort(descending);
+        REQUIRE(descending == ascending);
+        nstd::sort(ascending);
+        REQUIRE(descending == ascending);
+    }
+
+    SECTION("Test types without a radix key") {
+        nstd::vector<std::string> vec{"c", "a", "b"};
+        nstd::sort(vec);
+        REQUIRE(vec == nstd::vector<std::string>{"a", "b", "c"});
+    }
+
+#ifdef __SIZEOF_INT128__
+    SECTION("Test integers wider than 64 bits") {
+        // Would be truncated by the radix sort, so they should be left to std::sort
+        __extension__ using int128 = __int128;
+        STATIC_REQUIRE(!nstd::detail::radix_key<int128>);
+
+        nstd::vector<int128> vec;
+        for (int i = 0; i < 1000; ++i) {
+            vec.push_back(static_cast<int128>((i * 7919) % 1000) << 64);
+        }
+        nstd::sort(vec);
+        REQUIRE(std::is_sorted(vec.begin(), vec.end()));
+    }
+#endif
+}
+
+TEST_CASE("Test sort_by_key") {
+    const auto by_key_then_order = [](const entry &a, const entry &b) {
+        return a.key < b.key || (a.key == b.key && a.order < b.order);
+    };
+
+    for (const std::size_t n : {10U, 1000U, 100000U}) {
+        auto vec = random_entries(n);
+        nstd::sort_by_key(vec, &entry::key);
+        REQUIRE(std::is_sorted(vec.begin(), vec.end(), by_key_then_order));
+
+        vec = random_entries(n);
+        nstd::sort_by_key(vec, [](const entry &e) { return e.key; });
+        REQUIRE(std::is_sorted(vec.begin(), vec.end(), by_key_then_order));
+
+        vec = random_entries(n);
+        nstd::parallel_sort_by_key(vec, &entry::key, 4);
+        REQUIRE(vec.size() == n);
+        REQUIRE(std::is_sorted(vec.begin(), vec.end(), by_key_then_order));
+    }
+}
+
+TEST_CASE("Test sort_by_key uses radix sort") {
+    STATIC_REQUIRE(nstd::detail::radix_sortable_by<entry, decltype(&entry::key)>);
+
+    const auto by_key_then_order = [](const entry &a, const entry &b) {
+        return a.key < b.key || (a.key == b.key && a.order < b.order);
+    };
+
+    auto vec = random_entries<counting_allocator<entry>>(100000);
+    counting_allocator<entry>::allocations = 0;
+    nstd::sort_by_key(vec, &entry::key);
+    REQUIRE(counting_allocator<entry>::allocations == 1U);
+    REQUIRE(std::is_sorted(vec.begin(), vec.end(), by_key_then_order));
+
+    vec = random_entries<counting_allocator<entry>>(100000);
+    counting_allocator<entry>::allocations = 0;
+    nstd::parallel_sort_by_key(vec, &entry::key, 4);
+    REQUIRE(counting_allocator<entry>::allocations == 1U);
+    REQUIRE(std::is_sorted(vec.begin(), vec.end(), by_key_then_order));
+}
+
+TEST_CASE("Test parallel_sort") {
+    for (const std::size_t threads : {1U, 2U, 3U, 8U}) {
+        auto [integers, expected_integers] =
+            random_vectors<std::int64_t>(1 << 17, std::uniform_int_distribution<std::int64_t>{});
+        nstd::parallel_sort(integers, threads);
+        REQUIRE(equal(integers, expected_integers));
+
+        auto [floats, expected_floats] =
+            random_vectors<float>(1 << 17, std::uniform_real_distribution<float>{-1.0F, 1.0F});
+        nstd::parallel_sort(floats, threads);
+        REQUIRE(equal(floats, expected_floats));
+    }
+}
@@ -0,0 +1,185 @@
+#include "string.hh"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+TEST_CASE("Test string construction") {
+    STATIC_REQUIRE(sizeof(nstd::string) == 3 * sizeof(void *));
+
+    SECTION("Test short strings are stored inline") {
+        nstd::string empty;
+        REQUIRE(empty.empty());
+        REQUIRE(empty.is_short());
+        REQUIRE(std::strcmp(empty.c_str(), "") == 0);
+
+        nstd::string str("hello");
+        REQUIRE(str.size() == 5U);
+        REQUIRE(str.is_short());
+        REQUIRE(str == "hello");
+        REQUIRE(std::strcmp(str.c_str(), "hello") == 0);
+
+        // The longest string that fits inline
+        nstd::string longest(std::string(22, 'a'));
+        REQUIRE(longest.is_short());
+        REQUIRE(longest.capacity() == 22U);
+    }
+
+    SECTION("Test long strings are stored on the heap") {
+        const std::string expected(100, 'x');
+        nstd::string str(expected);
+        REQUIRE(!str.is_short());
+        REQUIRE(str.size() == 100U);
+        REQUIRE(str == expected);
+        REQUIRE(str.c_str()[100] == '\0');
+    }
+
+    SECTION("Test copy and move") {
+        for (const std::string_view contents : {"short", "a string that is too long to be stored inline"}) {
+            nstd::string str(contents);
+
+            // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+            nstd::string copied(str);
+            REQUIRE(copied == contents);
+            REQUIRE(copied.data() != str.data());
+
+            nstd::string moved(std::move(copied));
+            REQUIRE(moved == contents);
+            // NOLINTNEXTLINE(bugprone-use-after-move,hicpp-invalid-access-moved)
+            REQUIRE(copied.empty());
+
+            nstd::string assigned;
+            assigned = moved;
+            REQUIRE(assigned == contents);
+            assigned = std::move(moved);
+            REQUIRE(assigned == contents);
+
+            assigned = "other";
+            REQUIRE(assigned == "other");
+        }
+    }
+}
+
+TEST_CASE("Test string modification") {
+    SECTION("Test push_back moves to the heap when full") {
+        nstd::string str;
+        std::string expected;
+        for (int i = 0; i < 100; ++i) {
+            const char ch = static_cast<char>('a' + (i % 26));
+            str.push_back(ch);
+            expected.push_back(ch);
+            REQUIRE(str == expected);
+            REQUIRE(str.is_short() == (str.size() <= 22));
+        }
+        REQUIRE(str.back() == expected.back());
+
+        str.pop_back();
+        expected.pop_back();
+        REQUIRE(str == expected);
+    }
+
+    SECTION("Test append") {
+        nstd::string str("abc");
+        str.append("def").append(3, 'g');
+        str += "hij";
+        str += 'k';
+        REQUIRE(str == "abcdefggghijk");
+
+        // Appending a string to itself while it reallocates
+        str.append(str);
+        REQUIRE(str == "abcdefggghijkabcdefggghijk");
+        REQUIRE(!str.is_short());
+    }
+
+    SECTION("Test reserve does not change the contents") {
+        nstd::string str("abc");
+        str.reserve(1000);
+        REQUIRE(str.capacity() >= 1000U);
+        REQUIRE(str == "abc");
+
+        const auto *data = str.data();
+        for (int i = 0; i < 997; ++i) {
+            str.push_back('x');
+        }
+        REQUIRE(str.data() == data);
+    }
+
+    SECTION("Test resize") {
+        nstd::string str("abc");
+        str.resize(5, 'z');
+        REQUIRE(str == "abczz");
+        str.resize(2);
+        REQUIRE(str == "ab");
+        REQUIRE(str.c_str()[2] == '\0');
+    }
+
+    SECTION("Test resize_for_overwrite") {
+        nstd::string str("id:");
+        const auto old_size = str.size();
+        str.resize_for_overwrite(old_size + 40);
+        for (std::size_t i = old_size; i < str.size(); ++i) {
+            str[i] = '0';
+        }
+        REQUIRE(str == "id:" + std::string(40, '0'));
+        REQUIRE(str.c_str()[str.size()] == '\0');
+    }
+
+    SECTION("Test clear") {
+        nstd::string str(std::string(50, 'a'));
+        str.clear();
+        REQUIRE(str.empty());
+        REQUIRE(str == "");
+    }
+}
+
+TEST_CASE("Test string access") {
+    nstd::string str("abc");
+    REQUIRE(str[1] == 'b');
+    REQUIRE(str.at(2) == 'c');
+    REQUIRE_THROWS_AS(str.at(3), std::out_of_range);
+    REQUIRE(str.front() == 'a');
+
+    std::string reversed(str.begin(), str.end());
+    REQUIRE(reversed == "abc");
+}
+
+TEST_CASE("Test string comparison") {
+    const nstd::string a("abc");
+    const nstd::string b("abd");
+    REQUIRE(a == a);
+    REQUIRE(a != b);
+    REQUIRE(a < b);
+    REQUIRE(std::string_view("abc") == a);
+    REQUIRE(a < std::string_view("b"));
+}
+
+TEST_CASE("Test string integration") {
+    SECTION("Test string_view conversion") {
+        const nstd::string str("hello world");
+        const std::string_view view = str;
+        REQUIRE(view.substr(6) == "world");
+    }
+
+    SECTION("Test hash") {
+        const nstd::string str("key");
+        REQUIRE(std::hash<nstd::string>{}(str) == std::hash<std::string_view>{}("key"));
+
+        std::unordered_set<nstd::string> set;
+        set.insert(nstd::string("a"));
+        set.insert(nstd::string(std::string(30, 'b')));
+        REQUIRE(set.contains(nstd::string("a")));
+        REQUIRE(set.contains(nstd::string(std::string(30, 'b'))));
+        REQUIRE(!set.contains(nstd::string("c")));
+    }
+
+    SECTION("Test format") {
+        const nstd::string str("world");
+        REQUIRE(std::format("hello {}", str) == "hello world");
+    }
+}
@@ -1,7 +1,10 @@
 #include "unique_ptr.hh"
 
 #include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 
 struct complex_type {
     int x;
@@ -83,3 +86,55 @@ TEST_CASE("Test unique_ptr operator==") {
         REQUIRE(heap_child1 != heap_child2);
     }
 }
+
+TEST_CASE("Test unique_ptr for arrays") {
+    SECTION("Test array unique_ptr size is same as STL") {
+        STATIC_REQUIRE(sizeof(std::unique_ptr<int[]>) == sizeof(nstd::unique_ptr<int[]>));
+    }
+
+    SECTION("Test make_unique value initializes") {
+        auto heap_array = nstd::make_unique<int[]>(4);
+        for (std::size_t i = 0; i < 4; ++i) {
+            REQUIRE(heap_array[i] == 0);
+        }
+    }
+
+    SECTION("Test indexing") {
+        auto heap_array = nstd::make_unique_for_overwrite<int[]>(4);
+        for (std::size_t i = 0; i < 4; ++i) {
+            heap_array[i] = static_cast<int>(i);
+        }
+        REQUIRE(heap_array[3] == 3);
+        REQUIRE(heap_array.get()[2] == 2);
+    }
+
+    SECTION("Test move constructor") {
+        auto heap_array = nstd::make_unique<int[]>(2);
+        nstd::unique_ptr<int[]> moved(std::move(heap_array));
+        REQUIRE(heap_array.get() == nullptr);
+        REQUIRE(moved[0] == 0);
+    }
+}
+
+TEST_CASE("Test make_unique_for_overwrite") {
+    SECTION("Test single object") {
+        auto heap_int = nstd::make_unique_for_overwrite<int>();
+        *heap_int = 2;
+        REQUIRE(*heap_int == 2);
+    }
+
+    SECTION("Test aligned array") {
+        constexpr std::size_t alignment = 64;
+        auto buffer = nstd::make_unique_for_overwrite<float[]>(100, std::align_val_t{alignment});
+        REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.get()) % alignment == 0);
+        REQUIRE(buffer.get_deleter().size() == 100U);
+
+        buffer[99] = 1.0F;
+        REQUIRE(buffer[99] == 1.0F);
+
+        // The deleter needs to follow the pointer when moved, otherwise it would free with the wrong size/alignment
+        auto moved = std::move(buffer);
+        REQUIRE(moved.get_deleter().size() == 100U);
+        REQUIRE(buffer.get() == nullptr);
+    }
+}